@@ -0,0 +1,234 @@
+#ifndef ELF_LIB_H
+#define ELF_LIB_H
+
+#include "main.h"
+#include <elf.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/**
+ * enum elf_status_e - Outcome of elf_open
+ * @ELF_OK: The file is mapped and its header decoded
+ * @ELF_EOPEN: The file could not be opened
+ * @ELF_EREAD: The file could not be read or mapped
+ * @ELF_ENOTELF: The file is not an ELF file, or is truncated
+ */
+typedef enum elf_status_e
+{
+	ELF_OK,
+	ELF_EOPEN,
+	ELF_EREAD,
+	ELF_ENOTELF
+} elf_status_t;
+
+/**
+ * struct elf_codec_s - Decoders for one (class, byte order) pair
+ * @ehdr_size: size of the file header in this class
+ * @shdr_size: size of a section header in this class
+ * @phdr_size: size of a program header in this class
+ * @sym_size: size of a symbol in this class
+ * @dyn_size: size of a dynamic entry in this class
+ * @addr_size: size of an address (and of a GNU hash bloom word)
+ * @ehdr: decodes a file header
+ * @shdr: decodes a section header
+ * @phdr: decodes a program header
+ * @sym: decodes a symbol
+ * @dyn: decodes a dynamic entry
+ * @word: decodes a 32-bit word
+ * @addr: decodes an address-sized word
+ *
+ * Description: Generated by ELF_DEFINE_CODEC in 100-elf_codec.c and picked
+ * once per file, so decoding a field never tests the class or byte order.
+ */
+typedef struct elf_codec_s
+{
+	size_t ehdr_size;
+	size_t shdr_size;
+	size_t phdr_size;
+	size_t sym_size;
+	size_t dyn_size;
+	size_t addr_size;
+	void (*ehdr)(const unsigned char *p, Elf64_Ehdr *h);
+	void (*shdr)(const unsigned char *p, Elf64_Shdr *sh);
+	void (*phdr)(const unsigned char *p, Elf64_Phdr *ph);
+	void (*sym)(const unsigned char *p, Elf64_Sym *sym);
+	void (*dyn)(const unsigned char *p, Elf64_Dyn *dyn);
+	uint32_t (*word)(const unsigned char *p);
+	uint64_t (*addr)(const unsigned char *p);
+} elf_codec_t;
+
+/**
+ * struct elf_file_s - An ELF file mapped in memory
+ * @map: The whole file, read-only
+ * @size: Size of the file in bytes
+ * @codec: Decoders matching the class and byte order of the file
+ * @ehdr: The file header, decoded to host order and widened to 64 bits
+ * @heap: Nonzero if @map is a copy read into the heap, not a mapping
+ *
+ * Description: Accessors decode headers into the Elf64_* structures and
+ * hand out pointers into @map for strings and section contents, so
+ * nothing beyond the header fields is ever copied. A mapped file that
+ * is truncated while in use raises SIGBUS on the pages past its new end.
+ */
+typedef struct elf_file_s
+{
+	const unsigned char *map;
+	size_t size;
+	const elf_codec_t *codec;
+	Elf64_Ehdr ehdr;
+	int heap;
+} elf_file_t;
+
+/**
+ * struct elf_symentry_s - Symbol of an elf_symindex_t
+ * @value: address of the symbol
+ * @size: size of the symbol, 0 if unknown
+ * @name: name of the symbol, pointing into the mapping
+ * @index: index of the symbol in its table
+ * @end: highest end address of this entry and the ones before it in
+ *       by_addr, which bounds the search for an enclosing symbol
+ */
+typedef struct elf_symentry_s
+{
+	uint64_t value;
+	uint64_t size;
+	const char *name;
+	size_t index;
+	uint64_t end;
+} elf_symentry_t;
+
+/**
+ * struct elf_symindex_s - Address and name lookups over one ELF file
+ * @ef: the mapped file
+ * @dev: device of the file, part of the cache key
+ * @ino: inode of the file, part of the cache key
+ * @mtime: modification time of the file, part of the cache key
+ * @symtab: .symtab, or .dynsym when the file is stripped
+ * @dynsym: .dynsym, which the GNU hash table indexes
+ * @gnu_hash: GNU hash table inside the mapping, NULL if absent
+ * @gnu_hash_size: size of @gnu_hash in bytes
+ * @by_addr: defined symbols of @symtab sorted by address
+ * @naddr: number of entries of @by_addr
+ * @by_name: the same symbols sorted by name, NULL when @gnu_hash covers
+ *           every symbol of @symtab
+ * @refs: references, one held by the cache and one per elf_symindex_get
+ * @next: next index of the cache, most recently used first
+ */
+typedef struct elf_symindex_s
+{
+	elf_file_t ef;
+	dev_t dev;
+	ino_t ino;
+	struct timespec mtime;
+	Elf64_Shdr symtab;
+	Elf64_Shdr dynsym;
+	const unsigned char *gnu_hash;
+	size_t gnu_hash_size;
+	elf_symentry_t *by_addr;
+	size_t naddr;
+	elf_symentry_t *by_name;
+	unsigned int refs;
+	struct elf_symindex_s *next;
+} elf_symindex_t;
+
+/* First and largest buffer of a file that is read rather than mapped */
+#define ELF_READ_CHUNK (64UL << 10)
+#define ELF_READ_MAX (1UL << 30)
+
+/* Symbol indexes kept by elf_symindex_get, least recently used evicted */
+#define ELF_SYMCACHE_SIZE 32
+
+/* A path quoted for a record, where a byte takes up to six */
+#define ELF_QUOTED_MAX (PATH_MAX * 6)
+
+/* Paths waiting to be scanned by the batch workers */
+#define ELF_QUEUE_SIZE 1024
+
+/**
+ * struct elf_batch_s - Work queue of a batch scan
+ * @lock: protects every other field
+ * @not_empty: signalled when a path is queued or the walk ends
+ * @not_full: signalled when a path is taken
+ * @paths: ring of queued paths
+ * @head: index of the oldest queued path
+ * @count: number of queued paths
+ * @done: set once the walk has queued every path
+ * @workers: number of worker threads, 0 to scan from the walking thread
+ * @csv: 1 for CSV records, 0 for JSON lines
+ * @found: number of ELF files reported
+ */
+typedef struct elf_batch_s
+{
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	char *paths[ELF_QUEUE_SIZE];
+	size_t head;
+	size_t count;
+	int done;
+	int workers;
+	int csv;
+	unsigned long int found;
+} elf_batch_t;
+
+/* 100-elf_file.c */
+elf_status_t elf_fdopen(elf_file_t *ef, int fd);
+elf_status_t elf_open(elf_file_t *ef, const char *path);
+void elf_close(elf_file_t *ef);
+const void *elf_ptr(const elf_file_t *ef, uint64_t off, uint64_t size);
+
+/* 100-elf_read.c */
+elf_status_t elf_fdread(elf_file_t *ef, int fd);
+
+/* 100-elf_codec.c */
+extern const elf_codec_t elf_codec_lsb32;
+extern const elf_codec_t elf_codec_msb32;
+extern const elf_codec_t elf_codec_lsb64;
+extern const elf_codec_t elf_codec_msb64;
+const elf_codec_t *elf_codec(const unsigned char *ident);
+
+/* 100-elf_sections.c */
+int elf_shdr(const elf_file_t *ef, size_t i, Elf64_Shdr *sh);
+int elf_phdr(const elf_file_t *ef, size_t i, Elf64_Phdr *ph);
+const char *elf_string(const elf_file_t *ef, size_t strtab, size_t off);
+const char *elf_section_name(const elf_file_t *ef, const Elf64_Shdr *sh);
+int elf_find_section(const elf_file_t *ef, const char *name,
+		     Elf64_Word type, Elf64_Shdr *sh);
+
+/* 100-elf_symbols.c */
+size_t elf_entry_count(const elf_file_t *ef, const Elf64_Shdr *sh);
+int elf_sym(const elf_file_t *ef, const Elf64_Shdr *sh, size_t i,
+	    Elf64_Sym *sym);
+const char *elf_sym_name(const elf_file_t *ef, const Elf64_Shdr *sh,
+			 const Elf64_Sym *sym);
+int elf_dyn(const elf_file_t *ef, const Elf64_Shdr *sh, size_t i,
+	    Elf64_Dyn *dyn);
+
+/* 100-elf_symindex.c, 100-elf_gnuhash.c, 100-elf_symopen.c */
+int elf_symindex_load(elf_symindex_t *ix);
+int elf_symindex_addr(const elf_symindex_t *ix, uint64_t addr,
+		      Elf64_Sym *sym, const char **name);
+int elf_symindex_name(const elf_symindex_t *ix, const char *name,
+		      Elf64_Sym *sym);
+void elf_gnu_hash_find(elf_symindex_t *ix);
+int elf_gnu_hash_lookup(const elf_symindex_t *ix, const char *name,
+			Elf64_Sym *sym);
+elf_symindex_t *elf_symindex_open(int fd, const struct stat *st);
+void elf_symindex_unref(elf_symindex_t *ix);
+
+/* 100-elf_symcache.c */
+elf_symindex_t *elf_symindex_get(const char *path);
+void elf_symindex_put(elf_symindex_t *ix);
+void elf_symindex_clear(void);
+
+/* 100-elf_batch.c, 100-elf_record.c */
+int elf_batch(int argc, char *argv[], int csv);
+int elf_format_record(const elf_file_t *ef, const char *path, int csv,
+		      char *buf, size_t size);
+
+#endif /* ELF_LIB_H */
@@ -0,0 +1,192 @@
+#include "100-elf.h"
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * elf_batch_scan - reports one file if it is an ELF file
+ * @batch: work queue
+ * @path: path of the file
+ *
+ * Description: Only the four magic bytes are read before committing to
+ * mapping the file, so the bulk of a tree costs one open and one pread.
+ */
+static void elf_batch_scan(elf_batch_t *batch, const char *path)
+{
+	unsigned char magic[SELFMAG];
+	char record[ELF_QUOTED_MAX + 256];
+	elf_file_t ef;
+	ssize_t r;
+	int fd, n;
+
+	fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+	if (fd == -1)
+		return;
+	r = pread(fd, magic, SELFMAG, 0);
+	close(fd);
+	if (r != SELFMAG || memcmp(magic, ELFMAG, SELFMAG) != 0)
+		return;
+	if (elf_open(&ef, path) != ELF_OK)
+		return;
+
+	n = elf_format_record(&ef, path, batch->csv, record, sizeof(record));
+	elf_close(&ef);
+	if (n > 0)
+	{
+		fputs(record, stdout);
+		__sync_fetch_and_add(&batch->found, 1);
+	}
+}
+
+/**
+ * elf_batch_push - queues a path, waiting while the queue is full
+ * @batch: work queue
+ * @path: path to queue, owned by the queue
+ *
+ * Description: Without workers the path is scanned on the spot.
+ */
+static void elf_batch_push(elf_batch_t *batch, char *path)
+{
+	if (batch->workers == 0)
+	{
+		elf_batch_scan(batch, path);
+		free(path);
+		return;
+	}
+
+	pthread_mutex_lock(&batch->lock);
+	while (batch->count == ELF_QUEUE_SIZE)
+		pthread_cond_wait(&batch->not_full, &batch->lock);
+	batch->paths[(batch->head + batch->count++) % ELF_QUEUE_SIZE] = path;
+	pthread_cond_signal(&batch->not_empty);
+	pthread_mutex_unlock(&batch->lock);
+}
+
+/**
+ * elf_batch_worker - scans queued paths until the walk is over
+ * @arg: shared elf_batch_t
+ *
+ * Return: NULL
+ */
+static void *elf_batch_worker(void *arg)
+{
+	elf_batch_t *batch = arg;
+	char *path;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&batch->lock);
+		while (batch->count == 0 && !batch->done)
+			pthread_cond_wait(&batch->not_empty, &batch->lock);
+		if (batch->count == 0)
+		{
+			pthread_mutex_unlock(&batch->lock);
+			return (NULL);
+		}
+		path = batch->paths[batch->head];
+		batch->head = (batch->head + 1) % ELF_QUEUE_SIZE;
+		batch->count--;
+		pthread_cond_signal(&batch->not_full);
+		pthread_mutex_unlock(&batch->lock);
+
+		elf_batch_scan(batch, path);
+		free(path);
+	}
+}
+
+/**
+ * elf_batch_walk - queues every regular file below a path
+ * @batch: work queue
+ * @path: file or directory; symbolic links are not followed
+ */
+static void elf_batch_walk(elf_batch_t *batch, const char *path)
+{
+	struct stat st;
+	struct dirent *ent;
+	DIR *dp;
+	char *child;
+	size_t len = strlen(path);
+
+	if (lstat(path, &st) == -1)
+	{
+		dprintf(STDERR_FILENO, "Error: Can't read from file %s\n", path);
+		return;
+	}
+	if (S_ISREG(st.st_mode))
+	{
+		child = strdup(path);
+		if (child != NULL)
+			elf_batch_push(batch, child);
+		return;
+	}
+	if (!S_ISDIR(st.st_mode) || (dp = opendir(path)) == NULL)
+		return;
+
+	while ((ent = readdir(dp)) != NULL)
+	{
+		if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+			continue;
+		child = malloc(len + strlen(ent->d_name) + 2);
+		if (child == NULL)
+			break;
+		sprintf(child, "%s/%s", path, ent->d_name);
+		if (ent->d_type == DT_REG)
+			elf_batch_push(batch, child);
+		else if (ent->d_type == DT_DIR || ent->d_type == DT_UNKNOWN)
+		{
+			elf_batch_walk(batch, child);
+			free(child);
+		}
+		else
+			free(child);
+	}
+	closedir(dp);
+}
+
+/**
+ * elf_batch - scans files and directory trees for ELF files in parallel
+ * @argc: number of paths
+ * @argv: paths to scan
+ * @csv: 1 for CSV output with a header row, 0 for JSON lines
+ *
+ * Description: The calling thread walks the trees while one worker per
+ * online CPU filters and parses the files, printing one record per ELF.
+ * Return: 0 if at least one ELF file was found, 1 otherwise
+ */
+int elf_batch(int argc, char *argv[], int csv)
+{
+	elf_batch_t batch;
+	pthread_t threads[64];
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	int i, started;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.csv = csv;
+	pthread_mutex_init(&batch.lock, NULL);
+	pthread_cond_init(&batch.not_empty, NULL);
+	pthread_cond_init(&batch.not_full, NULL);
+	if (csv)
+		printf("path,class,data,osabi,abiversion,type,machine,entry,"
+		       "phnum,shnum\n");
+
+	n = (n < 1) ? 1 : (n > 64) ? 64 : n;
+	for (started = 0; started < n; started++)
+		if (pthread_create(&threads[started], NULL, elf_batch_worker,
+				   &batch) != 0)
+			break;
+	batch.workers = started;
+	for (i = 0; i < argc; i++)
+		elf_batch_walk(&batch, argv[i]);
+
+	pthread_mutex_lock(&batch.lock);
+	batch.done = 1;
+	pthread_cond_broadcast(&batch.not_empty);
+	pthread_mutex_unlock(&batch.lock);
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_cond_destroy(&batch.not_full);
+	pthread_cond_destroy(&batch.not_empty);
+	pthread_mutex_destroy(&batch.lock);
+	return (batch.found > 0 ? 0 : 1);
+}
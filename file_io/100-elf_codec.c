@@ -0,0 +1,150 @@
+#include "100-elf.h"
+#include <string.h>
+
+/*
+ * Byte swaps are picked by field size at compile time: every decoder
+ * below is straight-line code with no test on the byte order.
+ */
+#define ELF_SWAP_NONE(v) (v)
+#define ELF_SWAP_BYTES(v) \
+	(sizeof(v) == 2 ? __builtin_bswap16(v) : \
+	 sizeof(v) == 4 ? __builtin_bswap32(v) : \
+	 sizeof(v) == 8 ? __builtin_bswap64(v) : (uint64_t)(v))
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define ELF_SWAP_LSB ELF_SWAP_BYTES
+#define ELF_SWAP_MSB ELF_SWAP_NONE
+#else
+#define ELF_SWAP_LSB ELF_SWAP_NONE
+#define ELF_SWAP_MSB ELF_SWAP_BYTES
+#endif
+
+/*
+ * ELF_DEFINE_HEADERS - generates the file, section and program header
+ * decoders of one (class, byte order) pair
+ * @name: prefix of the generated functions
+ * @B: class, 32 or 64
+ * @SW: ELF_SWAP_NONE or ELF_SWAP_BYTES
+ */
+#define ELF_DEFINE_HEADERS(name, B, SW) \
+static void name##_ehdr(const unsigned char *p, Elf64_Ehdr *h) \
+{ \
+	Elf##B##_Ehdr r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	memcpy(h->e_ident, r.e_ident, EI_NIDENT); \
+	h->e_type = SW(r.e_type); \
+	h->e_machine = SW(r.e_machine); \
+	h->e_version = SW(r.e_version); \
+	h->e_entry = SW(r.e_entry); \
+	h->e_phoff = SW(r.e_phoff); \
+	h->e_shoff = SW(r.e_shoff); \
+	h->e_flags = SW(r.e_flags); \
+	h->e_ehsize = SW(r.e_ehsize); \
+	h->e_phentsize = SW(r.e_phentsize); \
+	h->e_phnum = SW(r.e_phnum); \
+	h->e_shentsize = SW(r.e_shentsize); \
+	h->e_shnum = SW(r.e_shnum); \
+	h->e_shstrndx = SW(r.e_shstrndx); \
+} \
+static void name##_shdr(const unsigned char *p, Elf64_Shdr *sh) \
+{ \
+	Elf##B##_Shdr r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	sh->sh_name = SW(r.sh_name); \
+	sh->sh_type = SW(r.sh_type); \
+	sh->sh_flags = SW(r.sh_flags); \
+	sh->sh_addr = SW(r.sh_addr); \
+	sh->sh_offset = SW(r.sh_offset); \
+	sh->sh_size = SW(r.sh_size); \
+	sh->sh_link = SW(r.sh_link); \
+	sh->sh_info = SW(r.sh_info); \
+	sh->sh_addralign = SW(r.sh_addralign); \
+	sh->sh_entsize = SW(r.sh_entsize); \
+} \
+static void name##_phdr(const unsigned char *p, Elf64_Phdr *ph) \
+{ \
+	Elf##B##_Phdr r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	ph->p_type = SW(r.p_type); \
+	ph->p_flags = SW(r.p_flags); \
+	ph->p_offset = SW(r.p_offset); \
+	ph->p_vaddr = SW(r.p_vaddr); \
+	ph->p_paddr = SW(r.p_paddr); \
+	ph->p_filesz = SW(r.p_filesz); \
+	ph->p_memsz = SW(r.p_memsz); \
+	ph->p_align = SW(r.p_align); \
+}
+
+/*
+ * ELF_DEFINE_CODEC - generates every decoder of one (class, byte order)
+ * pair and the elf_codec_t gathering them
+ * @name: name of the elf_codec_t, also prefix of the functions
+ * @B: class, 32 or 64
+ * @SW: ELF_SWAP_LSB or ELF_SWAP_MSB
+ */
+#define ELF_DEFINE_CODEC(name, B, SW) \
+ELF_DEFINE_HEADERS(name, B, SW) \
+static void name##_sym(const unsigned char *p, Elf64_Sym *sym) \
+{ \
+	Elf##B##_Sym r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	sym->st_name = SW(r.st_name); \
+	sym->st_info = r.st_info; \
+	sym->st_other = r.st_other; \
+	sym->st_shndx = SW(r.st_shndx); \
+	sym->st_value = SW(r.st_value); \
+	sym->st_size = SW(r.st_size); \
+} \
+static void name##_dyn(const unsigned char *p, Elf64_Dyn *dyn) \
+{ \
+	Elf##B##_Dyn r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	dyn->d_tag = (__typeof__(r.d_tag))SW(r.d_tag); \
+	dyn->d_un.d_val = SW(r.d_un.d_val); \
+} \
+static uint32_t name##_word(const unsigned char *p) \
+{ \
+	Elf32_Word r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	return (SW(r)); \
+} \
+static uint64_t name##_addr(const unsigned char *p) \
+{ \
+	Elf##B##_Addr r; \
+\
+	memcpy(&r, p, sizeof(r)); \
+	return (SW(r)); \
+} \
+const elf_codec_t name = { \
+	sizeof(Elf##B##_Ehdr), sizeof(Elf##B##_Shdr), \
+	sizeof(Elf##B##_Phdr), sizeof(Elf##B##_Sym), sizeof(Elf##B##_Dyn), \
+	sizeof(Elf##B##_Addr), name##_ehdr, name##_shdr, name##_phdr, \
+	name##_sym, name##_dyn, name##_word, name##_addr \
+}
+
+ELF_DEFINE_CODEC(elf_codec_lsb32, 32, ELF_SWAP_LSB);
+ELF_DEFINE_CODEC(elf_codec_msb32, 32, ELF_SWAP_MSB);
+ELF_DEFINE_CODEC(elf_codec_lsb64, 64, ELF_SWAP_LSB);
+ELF_DEFINE_CODEC(elf_codec_msb64, 64, ELF_SWAP_MSB);
+
+/**
+ * elf_codec - picks the decoders matching the identity of a file
+ * @ident: e_ident of the file
+ *
+ * Return: decoders for the class and byte order of the file
+ */
+const elf_codec_t *elf_codec(const unsigned char *ident)
+{
+	if (ident[EI_CLASS] == ELFCLASS64)
+		return (ident[EI_DATA] == ELFDATA2MSB ?
+			&elf_codec_msb64 : &elf_codec_lsb64);
+
+	return (ident[EI_DATA] == ELFDATA2MSB ?
+		&elf_codec_msb32 : &elf_codec_lsb32);
+}
@@ -0,0 +1,123 @@
+#include "100-elf.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * elf_ptr - bounds-checked pointer into the mapped file
+ * @ef: ELF file
+ * @off: file offset
+ * @size: number of bytes needed from @off
+ *
+ * Return: pointer to the bytes, or NULL if they run past the end of file
+ */
+const void *elf_ptr(const elf_file_t *ef, uint64_t off, uint64_t size)
+{
+	if (off > ef->size || size > ef->size - off)
+		return (NULL);
+
+	return (ef->map + off);
+}
+
+/**
+ * elf_decode_ehdr - checks the identity of the file and decodes its header
+ * @ef: ELF file, map and size set
+ *
+ * Return: ELF_OK, or ELF_ENOTELF
+ */
+static elf_status_t elf_decode_ehdr(elf_file_t *ef)
+{
+	if (ef->size < EI_NIDENT || memcmp(ef->map, ELFMAG, SELFMAG) != 0)
+		return (ELF_ENOTELF);
+
+	ef->codec = elf_codec(ef->map);
+	if (ef->size < ef->codec->ehdr_size)
+		return (ELF_ENOTELF);
+	ef->codec->ehdr(ef->map, &ef->ehdr);
+
+	return (ELF_OK);
+}
+
+/**
+ * elf_fdopen - maps an open ELF file and decodes its header
+ * @ef: ELF file to fill
+ * @fd: descriptor of the file, left open
+ *
+ * Description: The mapping stays valid after the file descriptor is
+ * closed and until elf_close; pages are only read as they are touched,
+ * so truncating the file meanwhile raises SIGBUS. Pipes, terminals and
+ * files that cannot be mapped or report no size, as in procfs, are read
+ * into the heap instead.
+ * Return: ELF_OK, ELF_EREAD or ELF_ENOTELF
+ */
+elf_status_t elf_fdopen(elf_file_t *ef, int fd)
+{
+	struct stat st;
+	void *map = MAP_FAILED;
+	elf_status_t status = ELF_OK;
+
+	ef->map = NULL;
+	ef->size = 0;
+	ef->heap = 0;
+	if (fstat(fd, &st) == -1 || S_ISDIR(st.st_mode))
+		return (ELF_EREAD);
+	if (S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size < EI_NIDENT)
+		return (ELF_ENOTELF);
+
+	if (S_ISREG(st.st_mode) && st.st_size > 0)
+		map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map != MAP_FAILED)
+	{
+		ef->map = map;
+		ef->size = st.st_size;
+	}
+	else
+		status = elf_fdread(ef, fd);
+	if (status == ELF_OK)
+		status = elf_decode_ehdr(ef);
+	if (status != ELF_OK)
+		elf_close(ef);
+	return (status);
+}
+
+/**
+ * elf_open - maps an ELF file and decodes its header
+ * @ef: ELF file to fill
+ * @path: path of the file
+ *
+ * Return: ELF_OK, ELF_EOPEN, ELF_EREAD or ELF_ENOTELF
+ */
+elf_status_t elf_open(elf_file_t *ef, const char *path)
+{
+	elf_status_t status;
+	int fd;
+
+	ef->map = NULL;
+	ef->size = 0;
+	ef->heap = 0;
+	fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return (ELF_EOPEN);
+	status = elf_fdopen(ef, fd);
+	close(fd);
+
+	return (status);
+}
+
+/**
+ * elf_close - unmaps or frees an ELF file
+ * @ef: ELF file opened by elf_open
+ */
+void elf_close(elf_file_t *ef)
+{
+	if (ef == NULL || ef->map == NULL)
+		return;
+
+	if (ef->heap)
+		free((void *)ef->map);
+	else
+		munmap((void *)ef->map, ef->size);
+	ef->map = NULL;
+	ef->size = 0;
+	ef->heap = 0;
+}
@@ -0,0 +1,111 @@
+#include "100-elf.h"
+#include <string.h>
+
+/**
+ * elf_vaddr_offset - converts a virtual address to a file offset
+ * @ef: ELF file
+ * @vaddr: address inside a PT_LOAD segment
+ *
+ * Return: file offset, or 0 if no segment maps @vaddr
+ */
+static uint64_t elf_vaddr_offset(const elf_file_t *ef, uint64_t vaddr)
+{
+	Elf64_Phdr ph;
+	size_t i;
+
+	for (i = 0; elf_phdr(ef, i, &ph); i++)
+	{
+		if (ph.p_type == PT_LOAD && vaddr >= ph.p_vaddr &&
+		    vaddr - ph.p_vaddr < ph.p_filesz)
+			return (ph.p_offset + (vaddr - ph.p_vaddr));
+	}
+
+	return (0);
+}
+
+/**
+ * elf_gnu_hash_find - locates the GNU hash table of a file
+ * @ix: symbol index, ef and dynsym set
+ *
+ * Description: Uses the SHT_GNU_HASH section, or the DT_GNU_HASH entry of
+ * the dynamic section when section headers do not name it.
+ */
+void elf_gnu_hash_find(elf_symindex_t *ix)
+{
+	Elf64_Shdr sh;
+	Elf64_Dyn dyn;
+	uint64_t off = 0;
+	size_t i;
+
+	ix->gnu_hash = NULL;
+	if (ix->dynsym.sh_size == 0)
+		return;
+	if (elf_find_section(&ix->ef, NULL, SHT_GNU_HASH, &sh))
+	{
+		ix->gnu_hash = elf_ptr(&ix->ef, sh.sh_offset, sh.sh_size);
+		ix->gnu_hash_size = sh.sh_size;
+		return;
+	}
+	if (elf_find_section(&ix->ef, NULL, SHT_DYNAMIC, &sh) == 0)
+		return;
+	for (i = 0; off == 0 && elf_dyn(&ix->ef, &sh, i, &dyn); i++)
+		if (dyn.d_tag == DT_GNU_HASH)
+			off = elf_vaddr_offset(&ix->ef, dyn.d_un.d_ptr);
+	if (off != 0 && off < ix->ef.size)
+	{
+		ix->gnu_hash = ix->ef.map + off;
+		ix->gnu_hash_size = ix->ef.size - off;
+	}
+}
+
+/**
+ * elf_gnu_hash_lookup - looks a name up in the GNU hash table
+ * @ix: symbol index with a GNU hash table
+ * @name: name of the symbol
+ * @sym: decoded symbol found in .dynsym
+ *
+ * Description: The bloom filter rejects most absent names after reading a
+ * single word; present names cost one bucket read and a short walk of
+ * their hash chain, comparing hashes before strings.
+ * Return: 1 if a defined symbol was found, 0 otherwise
+ */
+int elf_gnu_hash_lookup(const elf_symindex_t *ix, const char *name,
+			Elf64_Sym *sym)
+{
+	const elf_codec_t *c = ix->ef.codec;
+	const unsigned char *t = ix->gnu_hash, *chain;
+	uint32_t h = 5381, nbuckets, symoff, nbloom, shift, bits, i, h2;
+	uint64_t word, mask, need;
+	const char *s;
+
+	for (s = name; *s != '\0'; s++)
+		h = h * 33 + (unsigned char)*s;
+	if (ix->gnu_hash_size < 16)
+		return (0);
+	nbuckets = c->word(t), symoff = c->word(t + 4);
+	nbloom = c->word(t + 8), shift = c->word(t + 12);
+	bits = c->addr_size * 8;
+	need = 16 + (uint64_t)nbloom * c->addr_size + (uint64_t)nbuckets * 4;
+	if (nbuckets == 0 || nbloom == 0 || need > ix->gnu_hash_size)
+		return (0);
+
+	word = c->addr(t + 16 + ((h / bits) % nbloom) * c->addr_size);
+	mask = ((uint64_t)1 << (h % bits)) | ((uint64_t)1 << ((h >> shift) % bits));
+	if ((word & mask) != mask)
+		return (0);
+	i = c->word(t + 16 + nbloom * c->addr_size + (h % nbuckets) * 4);
+	chain = t + need;
+	for (; i >= symoff && need + (i - symoff + 1) * 4 <= ix->gnu_hash_size;
+	     i++)
+	{
+		h2 = c->word(chain + (i - symoff) * 4);
+		if ((h | 1) == (h2 | 1) && elf_sym(&ix->ef, &ix->dynsym, i, sym) &&
+		    sym->st_shndx != SHN_UNDEF && (s = elf_sym_name(&ix->ef,
+		    &ix->dynsym, sym)) != NULL && strcmp(s, name) == 0)
+			return (1);
+		if (h2 & 1)
+			break;
+	}
+
+	return (0);
+}
@@ -1,22 +1,5 @@
-#include "main.h"
-#include <elf.h>
-
-#define SWAP16(x) \
-	((((x) & 0x00FF) << 8) | (((x) & 0xFF00) >> 8))
-
-#define SWAP32(x) \
-	((((x) & 0x000000FFUL) << 24) | (((x) & 0x0000FF00UL) << 8) | \
-	(((x) & 0x00FF0000UL) >> 8) | (((x) & 0xFF000000UL) >> 24))
-
-#define SWAP64(x) \
-	((((x) & 0x00000000000000FFUL) << 56) | \
-	(((x) & 0x000000000000FF00UL) << 40) | \
-	(((x) & 0x0000000000FF0000UL) << 24) | \
-	(((x) & 0x00000000FF000000UL) << 8) | \
-	(((x) & 0x000000FF00000000UL) >> 8) | \
-	(((x) & 0x0000FF0000000000UL) >> 24) | \
-	(((x) & 0x00FF000000000000UL) >> 40) | \
-	(((x) & 0xFF00000000000000UL) >> 56))
+#include "100-elf.h"
+#include <string.h>
 
 /**
  * error - prints an error message and exits with status 98
@@ -121,32 +104,18 @@ void print_ident(const unsigned char *e)
 
 /**
  * print_type_entry - prints Type and Entry point address
- * @e: full header buffer
+ * @h: file header, decoded to host byte order
  *
  * Return: void
  */
-void print_type_entry(const unsigned char *e)
+void print_type_entry(const Elf64_Ehdr *h)
 {
-	int is_64, is_be;
 	unsigned int type;
 	unsigned long entry;
 	const char *t;
-	const Elf32_Ehdr *h32;
-	const Elf64_Ehdr *h64;
 
-	is_64 = (e[EI_CLASS] == ELFCLASS64);
-	is_be = (e[EI_DATA] == ELFDATA2MSB);
-	h32 = (const Elf32_Ehdr *)e;
-	h64 = (const Elf64_Ehdr *)e;
-
-	type = is_64 ? (unsigned int)h64->e_type : (unsigned int)h32->e_type;
-	entry = is_64 ? (unsigned long)h64->e_entry : (unsigned long)h32->e_entry;
-
-	if (is_be)
-	{
-		type = SWAP16(type);
-		entry = is_64 ? SWAP64(entry) : SWAP32(entry);
-	}
+	type = h->e_type;
+	entry = h->e_entry;
 
 	t = (type == ET_NONE) ? "NONE (None)" :
 		(type == ET_REL) ? "REL (Relocatable file)" :
@@ -172,47 +141,44 @@ void print_type_entry(const unsigned char *e)
  * @argc: number of arguments
  * @argv: array of arguments
  *
+ * Description: elf_header elf_filename, or elf_header -j|-c path... to
+ * scan whole trees and print one JSON line or CSV row per ELF file.
+ *
  * Return: 0 (Success)
  */
 int main(int argc, char *argv[])
 {
-	int fd;
-	ssize_t r;
-	unsigned char e[sizeof(Elf64_Ehdr)];
+	elf_file_t ef;
+	elf_status_t status;
 
+	if (argc >= 3 && (strcmp(argv[1], "-j") == 0 ||
+			  strcmp(argv[1], "-c") == 0))
+	{
+		return (elf_batch(argc - 2, argv + 2, argv[1][1] == 'c'));
+	}
 	if (argc != 2)
 	{
 		error(-1, NULL, "Usage: elf_header elf_filename\n");
 	}
 
-	fd = open(argv[1], O_RDONLY);
-	if (fd == -1)
+	status = elf_open(&ef, argv[1]);
+	if (status == ELF_EOPEN)
 	{
 		error(-1, argv[1], "Error: Can't open file %s\n");
 	}
-
-	r = read(fd, e, sizeof(e));
-	if (r == -1)
-	{
-		error(fd, argv[1], "Error: Can't read from file %s\n");
-	}
-
-	if (r < (ssize_t)EI_NIDENT ||
-		e[EI_MAG0] != ELFMAG0 || e[EI_MAG1] != ELFMAG1 ||
-		e[EI_MAG2] != ELFMAG2 || e[EI_MAG3] != ELFMAG3)
+	if (status == ELF_EREAD)
 	{
-		error(fd, argv[1], "Error: %s is not an ELF file\n");
+		error(-1, argv[1], "Error: Can't read from file %s\n");
 	}
-
-	if (close(fd) == -1)
+	if (status == ELF_ENOTELF)
 	{
-		dprintf(STDERR_FILENO, "Error: Can't close fd %d\n", fd);
-		exit(98);
+		error(-1, argv[1], "Error: %s is not an ELF file\n");
 	}
 
-	print_magic(e);
-	print_ident(e);
-	print_type_entry(e);
+	print_magic(ef.map);
+	print_ident(ef.map);
+	print_type_entry(&ef.ehdr);
+	elf_close(&ef);
 
 	return (0);
 }
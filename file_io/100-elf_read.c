@@ -0,0 +1,46 @@
+#include "100-elf.h"
+#include <errno.h>
+
+/**
+ * elf_fdread - reads a whole ELF file into the heap
+ * @ef: ELF file to fill
+ * @fd: descriptor of the file, left open
+ *
+ * Description: Used for what cannot be mapped, such as pipes, terminals
+ * and procfs files; reads from the current position until end of file
+ * or ELF_READ_MAX bytes, and elf_close frees the copy.
+ * Return: ELF_OK, or ELF_EREAD on a read or allocation error
+ */
+elf_status_t elf_fdread(elf_file_t *ef, int fd)
+{
+	unsigned char *buf = NULL, *grown;
+	size_t size = 0, cap = 0;
+	ssize_t r;
+
+	do {
+		if (size == cap)
+		{
+			cap = cap ? cap * 2 : ELF_READ_CHUNK;
+			grown = cap > ELF_READ_MAX ? NULL : realloc(buf, cap);
+			if (grown == NULL)
+			{
+				free(buf);
+				return (ELF_EREAD);
+			}
+			buf = grown;
+		}
+		r = read(fd, buf + size, cap - size);
+		if (r > 0)
+			size += r;
+	} while (r > 0 || (r == -1 && errno == EINTR));
+	if (r == -1)
+	{
+		free(buf);
+		return (ELF_EREAD);
+	}
+
+	ef->map = buf;
+	ef->size = size;
+	ef->heap = 1;
+	return (ELF_OK);
+}
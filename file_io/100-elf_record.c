@@ -0,0 +1,118 @@
+#include "100-elf.h"
+#include <string.h>
+
+/**
+ * elf_utf8_len - length of the UTF-8 sequence starting a string
+ * @s: the string, at a byte of 0x80 or more
+ *
+ * Description: Overlong forms, surrogates and code points past U+10FFFF
+ * are invalid, as JSON parsers reject them.
+ * Return: 2 to 4, or 0 if @s does not start a valid sequence
+ */
+static int elf_utf8_len(const unsigned char *s)
+{
+	unsigned char lo = 0x80, hi = 0xbf;
+	int len, i;
+
+	if (s[0] >= 0xc2 && s[0] <= 0xdf)
+		len = 2;
+	else if (s[0] >= 0xe0 && s[0] <= 0xef)
+		len = 3;
+	else if (s[0] >= 0xf0 && s[0] <= 0xf4)
+		len = 4;
+	else
+		return (0);
+	if (s[0] == 0xe0)
+		lo = 0xa0;
+	else if (s[0] == 0xed)
+		hi = 0x9f;
+	else if (s[0] == 0xf0)
+		lo = 0x90;
+	else if (s[0] == 0xf4)
+		hi = 0x8f;
+	if (s[1] < lo || s[1] > hi)
+		return (0);
+	for (i = 2; i < len; i++)
+		if (s[i] < 0x80 || s[i] > 0xbf)
+			return (0);
+
+	return (len);
+}
+
+/**
+ * elf_escape - copies a path into a JSON or CSV string literal
+ * @dst: output buffer
+ * @size: size of @dst
+ * @src: path to quote
+ * @csv: 1 for CSV quoting ("" for "), 0 for JSON escapes
+ *
+ * Description: Paths are bytes, not text, so in JSON each byte that is
+ * not part of a valid UTF-8 sequence becomes \u00XX, which keeps the
+ * output valid JSON at the cost of a lossy round trip for such names.
+ * Return: number of bytes written, not counting the '\0', or -1 if @dst
+ *         is too small
+ */
+static int elf_escape(char *dst, size_t size, const char *src, int csv)
+{
+	size_t n = 0;
+	unsigned char c;
+	int len;
+
+	for (; *src != '\0'; src++)
+	{
+		if (n + 8 >= size)
+			return (-1);
+		c = (unsigned char)*src;
+		len = !csv && c >= 0x80 ? elf_utf8_len((const void *)src) : 1;
+		if (csv && c == '"')
+			dst[n++] = '"';
+		else if (!csv && (c == '"' || c == '\\'))
+			dst[n++] = '\\';
+		else if (!csv && (c < 0x20 || len == 0))
+		{
+			n += sprintf(dst + n, "\\u%04x", c);
+			continue;
+		}
+		memcpy(dst + n, src, len);
+		n += len;
+		src += len - 1;
+	}
+	dst[n] = '\0';
+
+	return (n);
+}
+
+/**
+ * elf_format_record - formats the header of an ELF file as one record
+ * @ef: ELF file
+ * @path: path of the file
+ * @csv: 1 for a CSV row, 0 for a JSON object, both newline-terminated
+ * @buf: output buffer
+ * @size: size of @buf
+ *
+ * Description: CSV columns are path,class,data,osabi,abiversion,type,
+ * machine,entry,phnum,shnum; JSON keys use the same names.
+ * Return: length of the record, or -1 if @buf is too small
+ */
+int elf_format_record(const elf_file_t *ef, const char *path, int csv,
+		      char *buf, size_t size)
+{
+	const Elf64_Ehdr *h = &ef->ehdr;
+	char quoted[ELF_QUOTED_MAX];
+	const char *fmt;
+	int n;
+
+	if (elf_escape(quoted, sizeof(quoted), path, csv) == -1)
+		return (-1);
+
+	fmt = csv ? "\"%s\",%d,%d,%d,%d,%u,%u,0x%lx,%u,%u\n" :
+		"{\"path\":\"%s\",\"class\":%d,\"data\":%d,\"osabi\":%d,"
+		"\"abiversion\":%d,\"type\":%u,\"machine\":%u,"
+		"\"entry\":\"0x%lx\",\"phnum\":%u,\"shnum\":%u}\n";
+	n = snprintf(buf, size, fmt, quoted, h->e_ident[EI_CLASS],
+		     h->e_ident[EI_DATA], h->e_ident[EI_OSABI],
+		     h->e_ident[EI_ABIVERSION], h->e_type, h->e_machine,
+		     (unsigned long)h->e_entry, h->e_phnum, h->e_shnum);
+
+	return ((n < 0 || (size_t)n >= size) ? -1 : n);
+}
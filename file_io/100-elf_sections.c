@@ -0,0 +1,110 @@
+#include "100-elf.h"
+#include <string.h>
+
+/**
+ * elf_shdr - decodes a section header
+ * @ef: ELF file
+ * @i: index of the section
+ * @sh: decoded header
+ *
+ * Return: 1 on success, 0 if the section does not exist
+ */
+int elf_shdr(const elf_file_t *ef, size_t i, Elf64_Shdr *sh)
+{
+	const unsigned char *p;
+
+	if (i >= ef->ehdr.e_shnum || ef->ehdr.e_shentsize < ef->codec->shdr_size)
+		return (0);
+	p = elf_ptr(ef, ef->ehdr.e_shoff + i * ef->ehdr.e_shentsize,
+		    ef->ehdr.e_shentsize);
+	if (p == NULL)
+		return (0);
+
+	ef->codec->shdr(p, sh);
+	return (1);
+}
+
+/**
+ * elf_phdr - decodes a program header
+ * @ef: ELF file
+ * @i: index of the segment
+ * @ph: decoded header
+ *
+ * Return: 1 on success, 0 if the segment does not exist
+ */
+int elf_phdr(const elf_file_t *ef, size_t i, Elf64_Phdr *ph)
+{
+	const unsigned char *p;
+
+	if (i >= ef->ehdr.e_phnum || ef->ehdr.e_phentsize < ef->codec->phdr_size)
+		return (0);
+	p = elf_ptr(ef, ef->ehdr.e_phoff + i * ef->ehdr.e_phentsize,
+		    ef->ehdr.e_phentsize);
+	if (p == NULL)
+		return (0);
+
+	ef->codec->phdr(p, ph);
+	return (1);
+}
+
+/**
+ * elf_string - gets a string out of a string table section
+ * @ef: ELF file
+ * @strtab: index of the string table section
+ * @off: offset of the string in the table
+ *
+ * Return: pointer into the mapping, or NULL if out of bounds or unterminated
+ */
+const char *elf_string(const elf_file_t *ef, size_t strtab, size_t off)
+{
+	Elf64_Shdr sh;
+	const char *s;
+
+	if (elf_shdr(ef, strtab, &sh) == 0 || sh.sh_type == SHT_NOBITS ||
+	    off >= sh.sh_size)
+		return (NULL);
+	s = elf_ptr(ef, sh.sh_offset, sh.sh_size);
+	if (s == NULL || memchr(s + off, '\0', sh.sh_size - off) == NULL)
+		return (NULL);
+
+	return (s + off);
+}
+
+/**
+ * elf_section_name - gets the name of a section
+ * @ef: ELF file
+ * @sh: section header
+ *
+ * Return: pointer into the mapping, or NULL if the file has no names
+ */
+const char *elf_section_name(const elf_file_t *ef, const Elf64_Shdr *sh)
+{
+	return (elf_string(ef, ef->ehdr.e_shstrndx, sh->sh_name));
+}
+
+/**
+ * elf_find_section - looks a section up by name and/or type
+ * @ef: ELF file
+ * @name: name of the section, or NULL to match any name
+ * @type: type of the section, or SHT_NULL to match any type
+ * @sh: decoded header of the first match
+ *
+ * Return: index of the section, or 0 if none matches
+ */
+int elf_find_section(const elf_file_t *ef, const char *name,
+		     Elf64_Word type, Elf64_Shdr *sh)
+{
+	size_t i;
+	const char *s;
+
+	for (i = 1; elf_shdr(ef, i, sh); i++)
+	{
+		if (type != SHT_NULL && sh->sh_type != type)
+			continue;
+		s = (name != NULL) ? elf_section_name(ef, sh) : NULL;
+		if (name == NULL || (s != NULL && strcmp(s, name) == 0))
+			return (i);
+	}
+
+	return (0);
+}
@@ -0,0 +1,69 @@
+#include "100-elf.h"
+
+/**
+ * elf_entry_count - number of fixed-size entries in a table section
+ * @ef: ELF file
+ * @sh: header of a symbol table or dynamic section
+ *
+ * Return: number of entries fully inside the file, 0 if unusable
+ */
+size_t elf_entry_count(const elf_file_t *ef, const Elf64_Shdr *sh)
+{
+	if (sh->sh_entsize == 0 || sh->sh_type == SHT_NOBITS ||
+	    elf_ptr(ef, sh->sh_offset, sh->sh_size) == NULL)
+		return (0);
+
+	return (sh->sh_size / sh->sh_entsize);
+}
+
+/**
+ * elf_sym - decodes a symbol of a SHT_SYMTAB or SHT_DYNSYM section
+ * @ef: ELF file
+ * @sh: header of the symbol table
+ * @i: index of the symbol
+ * @sym: decoded symbol
+ *
+ * Return: 1 on success, 0 if the symbol does not exist
+ */
+int elf_sym(const elf_file_t *ef, const Elf64_Shdr *sh, size_t i,
+	    Elf64_Sym *sym)
+{
+	if (i >= elf_entry_count(ef, sh) || sh->sh_entsize < ef->codec->sym_size)
+		return (0);
+
+	ef->codec->sym(ef->map + sh->sh_offset + i * sh->sh_entsize, sym);
+	return (1);
+}
+
+/**
+ * elf_sym_name - gets the name of a symbol
+ * @ef: ELF file
+ * @sh: header of the symbol table the symbol comes from
+ * @sym: symbol
+ *
+ * Return: pointer into the mapping, or NULL if the symbol has no name
+ */
+const char *elf_sym_name(const elf_file_t *ef, const Elf64_Shdr *sh,
+			 const Elf64_Sym *sym)
+{
+	return (elf_string(ef, sh->sh_link, sym->st_name));
+}
+
+/**
+ * elf_dyn - decodes an entry of the SHT_DYNAMIC section
+ * @ef: ELF file
+ * @sh: header of the dynamic section
+ * @i: index of the entry
+ * @dyn: decoded entry
+ *
+ * Return: 1 on success, 0 past the end of the table or at DT_NULL
+ */
+int elf_dyn(const elf_file_t *ef, const Elf64_Shdr *sh, size_t i,
+	    Elf64_Dyn *dyn)
+{
+	if (i >= elf_entry_count(ef, sh) || sh->sh_entsize < ef->codec->dyn_size)
+		return (0);
+
+	ef->codec->dyn(ef->map + sh->sh_offset + i * sh->sh_entsize, dyn);
+	return (dyn->d_tag != DT_NULL);
+}
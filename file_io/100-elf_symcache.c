@@ -0,0 +1,145 @@
+#include "100-elf.h"
+
+static pthread_mutex_t elf_symcache_lock = PTHREAD_MUTEX_INITIALIZER;
+static elf_symindex_t *elf_symcache;
+static size_t elf_symcache_count;
+
+/**
+ * elf_symcache_find - looks a file up in the cache
+ * @st: status of the open file
+ *
+ * Description: Called with elf_symcache_lock held. A hit moves to the
+ * front of the cache. An entry for the same device and inode with
+ * another modification time is stale and dropped.
+ * Return: the index with a reference taken, or NULL if not cached
+ */
+static elf_symindex_t *elf_symcache_find(const struct stat *st)
+{
+	elf_symindex_t *ix, **link;
+
+	for (link = &elf_symcache; (ix = *link) != NULL; link = &ix->next)
+	{
+		if (ix->dev != st->st_dev || ix->ino != st->st_ino)
+			continue;
+		*link = ix->next;
+		if (ix->mtime.tv_sec == st->st_mtim.tv_sec &&
+		    ix->mtime.tv_nsec == st->st_mtim.tv_nsec)
+		{
+			ix->next = elf_symcache;
+			elf_symcache = ix;
+			ix->refs++;
+			return (ix);
+		}
+		elf_symcache_count--;
+		elf_symindex_unref(ix);
+		return (NULL);
+	}
+
+	return (NULL);
+}
+
+/**
+ * elf_symcache_insert - adds an index at the front of the cache
+ * @ix: the index, whose reference becomes the cache's
+ *
+ * Description: Called with elf_symcache_lock held. Past
+ * ELF_SYMCACHE_SIZE entries the least recently used one is dropped.
+ */
+static void elf_symcache_insert(elf_symindex_t *ix)
+{
+	elf_symindex_t **link;
+
+	ix->next = elf_symcache;
+	elf_symcache = ix;
+	if (++elf_symcache_count <= ELF_SYMCACHE_SIZE)
+		return;
+	for (link = &elf_symcache; (*link)->next != NULL;
+	     link = &(*link)->next)
+		;
+	ix = *link;
+	*link = NULL;
+	elf_symcache_count--;
+	elf_symindex_unref(ix);
+}
+
+/**
+ * elf_symindex_get - gets the symbol index of a file, building it once
+ * @path: path of the ELF file
+ *
+ * Description: Indexes are cached per process, keyed by the device,
+ * inode and modification time of the opened file, so a file reached
+ * through several paths is indexed once and a rebuilt one is indexed
+ * again. A miss builds the index outside the lock, so other lookups do
+ * not wait for it, then inserts it unless another thread got there
+ * first.
+ * Return: the index with a reference taken, to release with
+ * elf_symindex_put, or NULL if the file cannot be read as ELF
+ */
+elf_symindex_t *elf_symindex_get(const char *path)
+{
+	struct stat st;
+	elf_symindex_t *ix = NULL, *fresh = NULL;
+	int fd;
+
+	fd = path != NULL ? open(path, O_RDONLY) : -1;
+	if (fd == -1)
+		return (NULL);
+	if (fstat(fd, &st) == 0)
+	{
+		pthread_mutex_lock(&elf_symcache_lock);
+		ix = elf_symcache_find(&st);
+		pthread_mutex_unlock(&elf_symcache_lock);
+		if (ix == NULL)
+			fresh = elf_symindex_open(fd, &st);
+	}
+	close(fd);
+	if (fresh == NULL)
+		return (ix);
+
+	pthread_mutex_lock(&elf_symcache_lock);
+	ix = elf_symcache_find(&st);
+	if (ix == NULL)
+	{
+		elf_symcache_insert(fresh);
+		ix = fresh, ix->refs++, fresh = NULL;
+	}
+	pthread_mutex_unlock(&elf_symcache_lock);
+	if (fresh != NULL)
+		elf_symindex_unref(fresh);
+
+	return (ix);
+}
+
+/**
+ * elf_symindex_put - releases an index returned by elf_symindex_get
+ * @ix: the index, may be NULL
+ */
+void elf_symindex_put(elf_symindex_t *ix)
+{
+	if (ix == NULL)
+		return;
+	pthread_mutex_lock(&elf_symcache_lock);
+	elf_symindex_unref(ix);
+	pthread_mutex_unlock(&elf_symcache_lock);
+}
+
+/**
+ * elf_symindex_clear - empties the cache of symbol indexes
+ *
+ * Description: Indexes still held by a caller are freed by the last
+ * elf_symindex_put.
+ */
+void elf_symindex_clear(void)
+{
+	elf_symindex_t *ix;
+
+	pthread_mutex_lock(&elf_symcache_lock);
+	while (elf_symcache != NULL)
+	{
+		ix = elf_symcache;
+		elf_symcache = ix->next;
+		elf_symindex_unref(ix);
+	}
+	elf_symcache_count = 0;
+	pthread_mutex_unlock(&elf_symcache_lock);
+}
@@ -0,0 +1,164 @@
+#include "100-elf.h"
+#include <string.h>
+
+/**
+ * elf_addr_cmp - orders symbol entries by address
+ * @a: first entry
+ * @b: second entry
+ *
+ * Return: negative, 0 or positive
+ */
+static int elf_addr_cmp(const void *a, const void *b)
+{
+	const elf_symentry_t *x = a, *y = b;
+
+	if (x->value != y->value)
+		return (x->value < y->value ? -1 : 1);
+	return (x->size > y->size) - (x->size < y->size);
+}
+
+/**
+ * elf_name_cmp - orders symbol entries by name
+ * @a: first entry
+ * @b: second entry
+ *
+ * Return: negative, 0 or positive
+ */
+static int elf_name_cmp(const void *a, const void *b)
+{
+	return (strcmp(((const elf_symentry_t *)a)->name,
+		       ((const elf_symentry_t *)b)->name));
+}
+
+/**
+ * elf_symindex_load - builds the lookup tables of a mapped file
+ * @ix: index whose ef is open, other fields zeroed
+ *
+ * Description: Keeps the defined, named symbols of .symtab (.dynsym for
+ * stripped files) sorted by address. A copy sorted by name is only built
+ * when the GNU hash table cannot answer every name lookup, that is when
+ * it is missing or when .symtab holds more than .dynsym.
+ * Return: 1 on success, 0 on failure
+ */
+int elf_symindex_load(elf_symindex_t *ix)
+{
+	Elf64_Sym sym;
+	size_t i, n;
+	const char *name;
+
+	if (elf_find_section(&ix->ef, NULL, SHT_DYNSYM, &ix->dynsym) == 0)
+		memset(&ix->dynsym, 0, sizeof(ix->dynsym));
+	if (elf_find_section(&ix->ef, NULL, SHT_SYMTAB, &ix->symtab) == 0)
+		ix->symtab = ix->dynsym;
+	elf_gnu_hash_find(ix);
+
+	n = elf_entry_count(&ix->ef, &ix->symtab);
+	ix->by_addr = malloc(sizeof(elf_symentry_t) * (n + 1));
+	if (ix->by_addr == NULL)
+		return (0);
+	for (i = 0; i < n && elf_sym(&ix->ef, &ix->symtab, i, &sym); i++)
+	{
+		name = elf_sym_name(&ix->ef, &ix->symtab, &sym);
+		if (sym.st_shndx == SHN_UNDEF || sym.st_value == 0 ||
+		    name == NULL || *name == '\0' ||
+		    ELF64_ST_TYPE(sym.st_info) == STT_SECTION ||
+		    ELF64_ST_TYPE(sym.st_info) == STT_FILE ||
+		    ELF64_ST_TYPE(sym.st_info) == STT_TLS)
+			continue;
+		ix->by_addr[ix->naddr].value = sym.st_value;
+		ix->by_addr[ix->naddr].size = sym.st_size;
+		ix->by_addr[ix->naddr].name = name;
+		ix->by_addr[ix->naddr++].index = i;
+	}
+	qsort(ix->by_addr, ix->naddr, sizeof(elf_symentry_t), elf_addr_cmp);
+	for (i = 0; i < ix->naddr; i++)
+	{
+		ix->by_addr[i].end = ix->by_addr[i].value + ix->by_addr[i].size;
+		if (i > 0 && ix->by_addr[i - 1].end > ix->by_addr[i].end)
+			ix->by_addr[i].end = ix->by_addr[i - 1].end;
+	}
+
+	if (ix->gnu_hash != NULL &&
+	    ix->symtab.sh_offset == ix->dynsym.sh_offset)
+		return (1);
+	ix->by_name = malloc(sizeof(elf_symentry_t) * (ix->naddr + 1));
+	if (ix->by_name == NULL)
+		return (0);
+	memcpy(ix->by_name, ix->by_addr, sizeof(elf_symentry_t) * ix->naddr);
+	qsort(ix->by_name, ix->naddr, sizeof(elf_symentry_t), elf_name_cmp);
+	return (1);
+}
+
+/**
+ * elf_symindex_addr - finds the symbol covering an address
+ * @ix: symbol index
+ * @addr: address to symbolize
+ * @sym: decoded symbol found
+ * @name: set to the name of the symbol found
+ *
+ * Description: Binary search for the last symbol starting at or before
+ * @addr. An unsized one (hand written assembly) is taken as reaching up
+ * to the next symbol. Otherwise the search walks back to the nearest
+ * symbol containing @addr, so an address past a nested symbol still
+ * finds the one enclosing it; it stops as soon as the highest end
+ * address of the symbols left is at or below @addr.
+ * Return: 1 if a symbol was found, 0 otherwise
+ */
+int elf_symindex_addr(const elf_symindex_t *ix, uint64_t addr,
+		      Elf64_Sym *sym, const char **name)
+{
+	size_t lo = 0, hi = ix->naddr, mid;
+	const elf_symentry_t *e;
+
+	while (lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (ix->by_addr[mid].value <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return (0);
+
+	e = &ix->by_addr[lo - 1];
+	if (e->size != 0)
+	{
+		while (addr - e->value >= e->size)
+		{
+			if (e == ix->by_addr || e[-1].end <= addr)
+				return (0);
+			e--;
+		}
+	}
+
+	*name = e->name;
+	return (elf_sym(&ix->ef, &ix->symtab, e->index, sym));
+}
+
+/**
+ * elf_symindex_name - finds a symbol by name
+ * @ix: symbol index
+ * @name: name of the symbol
+ * @sym: decoded symbol found
+ *
+ * Return: 1 if a defined symbol was found, 0 otherwise
+ */
+int elf_symindex_name(const elf_symindex_t *ix, const char *name,
+		      Elf64_Sym *sym)
+{
+	elf_symentry_t key, *e;
+
+	if (ix->gnu_hash != NULL && elf_gnu_hash_lookup(ix, name, sym))
+		return (1);
+	if (ix->by_name == NULL)
+		return (0);
+
+	key.name = name;
+	e = bsearch(&key, ix->by_name, ix->naddr, sizeof(elf_symentry_t),
+		    elf_name_cmp);
+	if (e == NULL)
+		return (0);
+
+	return (elf_sym(&ix->ef, &ix->symtab, e->index, sym));
+}
@@ -0,0 +1,59 @@
+#include "100-elf.h"
+
+/**
+ * elf_symindex_free - releases one symbol index
+ * @ix: index to free
+ */
+static void elf_symindex_free(elf_symindex_t *ix)
+{
+	elf_close(&ix->ef);
+	free(ix->by_addr);
+	free(ix->by_name);
+	free(ix);
+}
+
+/**
+ * elf_symindex_open - maps an open file and builds its symbol index
+ * @fd: descriptor of the ELF file, left open
+ * @st: status of @fd, giving the cache key
+ *
+ * Return: the new index with one reference, or NULL on failure
+ */
+elf_symindex_t *elf_symindex_open(int fd, const struct stat *st)
+{
+	elf_symindex_t *ix;
+
+	ix = calloc(1, sizeof(elf_symindex_t));
+	if (ix == NULL)
+		return (NULL);
+	if (elf_fdopen(&ix->ef, fd) != ELF_OK)
+	{
+		free(ix);
+		return (NULL);
+	}
+	ix->dev = st->st_dev;
+	ix->ino = st->st_ino;
+	ix->mtime = st->st_mtim;
+	ix->refs = 1;
+	if (elf_symindex_load(ix) == 0)
+	{
+		elf_symindex_free(ix);
+		return (NULL);
+	}
+
+	return (ix);
+}
+
+/**
+ * elf_symindex_unref - drops a reference to an index
+ * @ix: the index, called with the cache lock held unless nobody else
+ *      knows it
+ *
+ * Description: The index is freed with its last reference, so a caller
+ * keeps using an index evicted from the cache meanwhile.
+ */
+void elf_symindex_unref(elf_symindex_t *ix)
+{
+	if (--ix->refs == 0)
+		elf_symindex_free(ix);
+}
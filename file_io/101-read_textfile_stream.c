@@ -0,0 +1,114 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <errno.h>
+
+#define STREAM_CHUNK 65536
+#define STREAM_SPLICE_MAX (1 << 30)
+
+/**
+ * stream_write - writes a whole buffer to standard output
+ * @buf: bytes to write
+ * @len: number of bytes
+ *
+ * Return: number of bytes written, less than @len only on error
+ */
+static size_t stream_write(const char *buf, size_t len)
+{
+	size_t done = 0;
+	ssize_t w;
+
+	while (done < len)
+	{
+		w = write(STDOUT_FILENO, buf + done, len - done);
+		if (w == -1 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			break;
+		done += w;
+	}
+
+	return (done);
+}
+
+/**
+ * stream_splice - moves file data to standard output inside the kernel
+ * @fd: file to read from, at its current offset
+ * @letters: maximum number of bytes to move
+ * @moved: incremented by the number of bytes moved
+ *
+ * Description: splice needs a pipe on one side, so this only works when
+ * standard output is a pipe; the file offset advances with the data.
+ * Return: 1 if the copy is finished (EOF, @letters or a hard error),
+ * 0 if the caller must carry on with read/write
+ */
+static int stream_splice(int fd, size_t letters, size_t *moved)
+{
+	ssize_t n;
+	size_t left;
+
+	while (*moved < letters)
+	{
+		left = letters - *moved;
+		n = splice(fd, NULL, STDOUT_FILENO, NULL,
+			   left < STREAM_SPLICE_MAX ? left : STREAM_SPLICE_MAX,
+			   SPLICE_F_MOVE);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n == -1)
+			return (errno != EINVAL && errno != ENOSYS);
+		if (n == 0)
+			break;
+		*moved += n;
+	}
+
+	return (1);
+}
+
+/**
+ * read_textfile_stream - Reads a text file and prints it to
+ *                        the POSIX standard output in chunks.
+ * @filename: The name of the file to read.
+ * @letters: The maximum number of letters to read and print.
+ *
+ * Description: Unlike read_textfile, memory use does not grow with
+ * @letters: data is spliced to a piped stdout, or copied through one
+ * reused buffer of at most STREAM_CHUNK bytes. Short reads and writes
+ * are retried until EOF or @letters.
+ * Return: The actual number of letters it could read and print,
+ *         0 if the file cannot be opened
+ */
+ssize_t read_textfile_stream(const char *filename, size_t letters)
+{
+	int f;
+	ssize_t r;
+	size_t total = 0, size, w;
+	char *s = NULL;
+
+	if (filename == NULL)
+		return (0);
+	f = open(filename, O_RDONLY);
+	if (f == -1)
+		return (0);
+
+	if (!stream_splice(f, letters, &total))
+	{
+		size = letters - total < STREAM_CHUNK ? letters - total : STREAM_CHUNK;
+		s = malloc(sizeof(char) * size);
+		while (s != NULL && total < letters)
+		{
+			r = read(f, s, letters - total < size ? letters - total : size);
+			if (r == -1 && errno == EINTR)
+				continue;
+			if (r <= 0)
+				break;
+			w = stream_write(s, r);
+			total += w;
+			if (w < (size_t)r)
+				break;
+		}
+		free(s);
+	}
+	close(f);
+
+	return (total);
+}
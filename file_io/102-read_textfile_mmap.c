@@ -0,0 +1,234 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MMAP_CACHE_SIZE 8
+
+/**
+ * struct mmap_entry - a file mapped read-only
+ * @dev: device of the file
+ * @ino: inode of the file
+ * @mtime: modification time when mapped
+ * @fd: the file, kept open to check it has not changed before each use
+ * @map: start of the mapping
+ * @size: size of the file and of the mapping
+ * @refs: references, one held by the cache and one per current reader
+ * @used: tick of the last lookup, for LRU eviction
+ */
+typedef struct mmap_entry
+{
+	dev_t dev;
+	ino_t ino;
+	struct timespec mtime;
+	int fd;
+	char *map;
+	size_t size;
+	unsigned int refs;
+	unsigned long used;
+} mmap_entry_t;
+
+static pthread_mutex_t mmap_lock = PTHREAD_MUTEX_INITIALIZER;
+static mmap_entry_t *mmap_cache[MMAP_CACHE_SIZE];
+static unsigned long mmap_tick;
+
+/**
+ * mmap_put - drops a reference to an entry
+ * @e: the entry, called with mmap_lock held unless nobody else knows it
+ *
+ * Description: The mapping is released with the last reference, so a
+ * reader keeps using an entry evicted or invalidated meanwhile.
+ */
+static void mmap_put(mmap_entry_t *e)
+{
+	if (--e->refs > 0)
+		return;
+	munmap(e->map, e->size);
+	close(e->fd);
+	free(e);
+}
+
+/**
+ * mmap_map - maps a whole file for sequential reading
+ * @filename: path of the file
+ *
+ * Description: Runs without mmap_lock, so a slow open or mmap does not
+ * hold up readers of other files.
+ * Return: a new entry with one reference, or NULL on failure
+ */
+static mmap_entry_t *mmap_map(const char *filename)
+{
+	mmap_entry_t *e;
+	struct stat st;
+
+	e = malloc(sizeof(mmap_entry_t));
+	if (e == NULL)
+		return (NULL);
+	e->fd = open(filename, O_RDONLY);
+	e->map = MAP_FAILED;
+	if (e->fd != -1 && fstat(e->fd, &st) == 0 && S_ISREG(st.st_mode) &&
+	    st.st_size > 0)
+		e->map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+			      e->fd, 0);
+	if (e->map == MAP_FAILED)
+	{
+		if (e->fd != -1)
+			close(e->fd);
+		free(e);
+		return (NULL);
+	}
+	madvise(e->map, st.st_size, MADV_SEQUENTIAL);
+	e->dev = st.st_dev;
+	e->ino = st.st_ino;
+	e->mtime = st.st_mtim;
+	e->size = st.st_size;
+	e->refs = 1;
+
+	return (e);
+}
+
+/**
+ * mmap_find - looks a file up in the cache
+ * @st: status of the file, for its device and inode
+ * @slot: set to the slot of the least recently used or a free entry
+ *
+ * Description: Called with mmap_lock held. The entry's file is checked
+ * with fstat right here, under the lock: an entry whose file shrank or
+ * was modified is dropped, so a file truncated by log rotation is not
+ * read through a mapping now longer than the file.
+ * Return: the entry with a reference taken, or NULL if not cached
+ */
+static mmap_entry_t *mmap_find(const struct stat *st, int *slot)
+{
+	mmap_entry_t *e = NULL, *c;
+	struct stat now;
+	int i;
+
+	for (*slot = 0, i = 0; i < MMAP_CACHE_SIZE && e == NULL; i++)
+	{
+		c = mmap_cache[i];
+		if (c != NULL && c->dev == st->st_dev && c->ino == st->st_ino)
+		{
+			if (fstat(c->fd, &now) == 0 &&
+			    now.st_size == (off_t)c->size &&
+			    now.st_mtim.tv_sec == c->mtime.tv_sec &&
+			    now.st_mtim.tv_nsec == c->mtime.tv_nsec)
+				e = c, e->refs++;
+			else
+				mmap_cache[i] = NULL, mmap_put(c);
+		}
+		if (mmap_cache[*slot] != NULL && (mmap_cache[i] == NULL ||
+		    mmap_cache[i]->used < mmap_cache[*slot]->used))
+			*slot = i;
+	}
+
+	return (e);
+}
+
+/**
+ * mmap_get - returns the cached mapping of a file, mapping it if needed
+ * @filename: path of the file
+ *
+ * Description: Entries are keyed by device and inode. On a miss the file
+ * is mapped outside the lock, then inserted in place of the least
+ * recently used entry, unless another reader mapped it meanwhile.
+ * Return: the entry with a reference taken, or NULL on failure
+ */
+static mmap_entry_t *mmap_get(const char *filename)
+{
+	struct stat st;
+	mmap_entry_t *e, *fresh = NULL;
+	int slot;
+
+	if (stat(filename, &st) == -1 || !S_ISREG(st.st_mode) ||
+	    st.st_size == 0)
+		return (NULL);
+	pthread_mutex_lock(&mmap_lock);
+	e = mmap_find(&st, &slot);
+	if (e == NULL)
+	{
+		pthread_mutex_unlock(&mmap_lock);
+		fresh = mmap_map(filename);
+		pthread_mutex_lock(&mmap_lock);
+		e = fresh != NULL ? mmap_find(&st, &slot) : NULL;
+	}
+	if (e == NULL && fresh != NULL)
+	{
+		if (mmap_cache[slot] != NULL)
+			mmap_put(mmap_cache[slot]);
+		mmap_cache[slot] = fresh;
+		e = fresh, e->refs++, fresh = NULL;
+	}
+	if (e != NULL)
+		e->used = ++mmap_tick;
+	if (fresh != NULL)
+		mmap_put(fresh);
+	pthread_mutex_unlock(&mmap_lock);
+
+	return (e);
+}
+
+/**
+ * read_textfile_mmap - Reads a text file through a cached mapping and
+ *                      prints it to the POSIX standard output.
+ * @filename: The name of the file to read.
+ * @letters: The maximum number of letters to read and print.
+ *
+ * Description: Repeated calls on the same file reuse its mapping, so
+ * the data is written to stdout straight from the page cache without
+ * being copied into a heap buffer. Short writes and EINTR are retried.
+ * A file truncated after the check in mmap_find, while it is being
+ * written out, ends the output early: the pages past the new end are
+ * only touched by the kernel inside write, which then fails with EFAULT
+ * instead of the process receiving SIGBUS. Whatever cannot be mapped,
+ * such as empty, procfs and special files, goes through read_textfile.
+ * Return: The actual number of letters it could read and print
+ */
+ssize_t read_textfile_mmap(const char *filename, size_t letters)
+{
+	mmap_entry_t *e;
+	size_t len, done = 0;
+	ssize_t w;
+
+	if (filename == NULL)
+		return (0);
+	e = mmap_get(filename);
+	if (e == NULL)
+		return (read_textfile(filename, letters));
+
+	len = letters < e->size ? letters : e->size;
+	while (done < len)
+	{
+		w = write(STDOUT_FILENO, e->map + done, len - done);
+		if (w == -1 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			break;
+		done += w;
+	}
+
+	pthread_mutex_lock(&mmap_lock);
+	mmap_put(e);
+	pthread_mutex_unlock(&mmap_lock);
+
+	return (done);
+}
+
+/**
+ * read_textfile_mmap_clear - unmaps every cached file
+ */
+void read_textfile_mmap_clear(void)
+{
+	int i;
+
+	pthread_mutex_lock(&mmap_lock);
+	for (i = 0; i < MMAP_CACHE_SIZE; i++)
+		if (mmap_cache[i] != NULL)
+		{
+			mmap_put(mmap_cache[i]);
+			mmap_cache[i] = NULL;
+		}
+	pthread_mutex_unlock(&mmap_lock);
+}
@@ -0,0 +1,209 @@
+#include "103-appender.h"
+#include <string.h>
+
+/**
+ * appender_open - Opens a file for buffered appends.
+ * @filename: The name of the file, which must already exist.
+ * @max_bytes: Buffered bytes that trigger a flush.
+ * @flush_ms: Flush records older than this many milliseconds,
+ *            0 for no time threshold.
+ * @sync: Nonzero to make each append durable before it returns.
+ *
+ * Return: The appender, or NULL if the file cannot be opened
+ *         for writing.
+ */
+appender_t *appender_open(const char *filename, size_t max_bytes,
+			  long flush_ms, int sync)
+{
+	appender_t *ap;
+	pthread_condattr_t attr;
+
+	if (filename == NULL)
+		return (NULL);
+	ap = calloc(1, sizeof(appender_t));
+	if (ap == NULL)
+		return (NULL);
+	ap->fd = open(filename, O_WRONLY | O_APPEND);
+	if (ap->fd == -1)
+	{
+		free(ap);
+		return (NULL);
+	}
+	ap->max_bytes = max_bytes;
+	ap->flush_ms = flush_ms;
+	ap->sync = sync;
+	pthread_mutex_init(&ap->lock, NULL);
+	pthread_mutex_init(&ap->io_lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&ap->kick, &attr);
+	pthread_condattr_destroy(&attr);
+	pthread_cond_init(&ap->synced, NULL);
+	if (flush_ms > 0 &&
+	    pthread_create(&ap->flusher, NULL, appender_flusher, ap) != 0)
+		ap->flush_ms = 0;
+
+	return (ap);
+}
+
+/**
+ * appender_unbuffer - Drops the part of a record already buffered.
+ * @ap: The appender, with its lock held.
+ * @tail: The last block before the record, NULL if there was none.
+ * @used: The bytes @tail held before the record.
+ * @pending: The buffered bytes before the record.
+ *
+ * Description: Blocks the record started go back to the spare list, so
+ * a record either is buffered whole or not at all.
+ */
+static void appender_unbuffer(appender_t *ap, appender_chunk_t *tail,
+			      size_t used, size_t pending)
+{
+	appender_chunk_t *c = tail != NULL ? tail->next : ap->head;
+
+	if (c != NULL)
+	{
+		ap->tail->next = ap->spare;
+		ap->spare = c;
+	}
+	if (tail != NULL)
+	{
+		tail->next = NULL;
+		tail->len = used;
+	}
+	else
+		ap->head = NULL;
+	ap->tail = tail;
+	ap->pending = pending;
+}
+
+/**
+ * appender_buffer - Copies a record at the end of the buffered blocks.
+ * @ap: The appender, with its lock held.
+ * @text: The record.
+ * @len: The length of the record.
+ *
+ * Return: 1 on success, -1 if memory runs out (nothing is buffered).
+ */
+static int appender_buffer(appender_t *ap, const char *text, size_t len)
+{
+	appender_chunk_t *c, *tail = ap->tail;
+	size_t n, used = tail != NULL ? tail->len : 0, pending = ap->pending;
+
+	while (len > 0)
+	{
+		c = ap->tail;
+		if (c == NULL || c->len == APPENDER_CHUNK)
+		{
+			c = ap->spare;
+			if (c != NULL)
+				ap->spare = c->next;
+			else
+				c = malloc(sizeof(appender_chunk_t));
+			if (c == NULL)
+			{
+				appender_unbuffer(ap, tail, used, pending);
+				return (-1);
+			}
+			c->next = NULL;
+			c->len = 0;
+			c->mark = 0;
+			if (ap->tail != NULL)
+				ap->tail->next = c;
+			else
+				ap->head = c;
+			ap->tail = c;
+		}
+		n = APPENDER_CHUNK - c->len;
+		if (n > len)
+			n = len;
+		memcpy(c->data + c->len, text, n);
+		c->len += n, ap->pending += n;
+		text += n, len -= n;
+	}
+	if (ap->tail != NULL)
+		ap->tail->mark = ap->tail->len;
+
+	return (1);
+}
+
+/**
+ * appender_append - Appends text at the end of an appender's file.
+ * @ap: The appender.
+ * @text_content: The NULL terminated string to add.
+ *
+ * Description: The text is buffered and written with the following
+ * records by writev once max_bytes are pending or the oldest record
+ * is flush_ms old. Writes keep O_APPEND semantics and never split a
+ * record, so records of concurrent writers do not interleave. The
+ * flusher thread is only woken when the first record is buffered, to
+ * arm its deadline, or when the buffer is full, so appends in between
+ * cost no wakeup.
+ * Return: -1 on failure, 1 otherwise.
+ */
+int appender_append(appender_t *ap, const char *text_content)
+{
+	int r, full, first;
+
+	if (ap == NULL)
+		return (-1);
+	if (text_content == NULL)
+		return (1);
+	pthread_mutex_lock(&ap->lock);
+	first = ap->pending == 0;
+	if (first)
+		clock_gettime(CLOCK_MONOTONIC, &ap->since);
+	r = ap->failed || ap->closing ? -1 :
+		appender_buffer(ap, text_content, strlen(text_content));
+	if (r == 1)
+		ap->appended++;
+	full = ap->pending >= ap->max_bytes;
+	if (r == 1 && ap->pending > 0 && (first || full))
+		pthread_cond_signal(&ap->kick);
+	pthread_mutex_unlock(&ap->lock);
+
+	if (r == 1 && full)
+		r = appender_flush(ap);
+	if (r == 1 && ap->sync)
+		r = appender_sync(ap);
+
+	return (r);
+}
+
+/**
+ * appender_close - Flushes an appender and closes its file.
+ * @ap: The appender.
+ *
+ * Return: -1 if a write or the close failed, 1 otherwise.
+ */
+int appender_close(appender_t *ap)
+{
+	appender_chunk_t *c;
+	int r;
+
+	if (ap == NULL)
+		return (-1);
+	pthread_mutex_lock(&ap->lock);
+	ap->closing = 1;
+	pthread_cond_signal(&ap->kick);
+	pthread_mutex_unlock(&ap->lock);
+	if (ap->flush_ms > 0)
+		pthread_join(ap->flusher, NULL);
+
+	r = ap->sync ? appender_sync(ap) : appender_flush(ap);
+	if (close(ap->fd) == -1)
+		r = -1;
+	while (ap->spare != NULL)
+	{
+		c = ap->spare;
+		ap->spare = c->next;
+		free(c);
+	}
+	pthread_cond_destroy(&ap->synced);
+	pthread_cond_destroy(&ap->kick);
+	pthread_mutex_destroy(&ap->io_lock);
+	pthread_mutex_destroy(&ap->lock);
+	free(ap);
+
+	return (r);
+}
@@ -0,0 +1,90 @@
+#ifndef APPENDER_H
+#define APPENDER_H
+
+#include "main.h"
+#include <pthread.h>
+#include <sys/uio.h>
+#include <time.h>
+
+/* Size of the blocks records are packed into */
+#define APPENDER_CHUNK (1 << 16)
+/* Blocks handed to one writev call; larger records are written whole */
+#define APPENDER_IOV 64
+
+/**
+ * struct appender_chunk_s - Block of buffered records
+ * @next: next block, in append order
+ * @len: bytes used in @data
+ * @mark: bytes of @data up to the end of the last record ending in this
+ *        block, 0 if none does
+ * @data: record bytes, records may span blocks
+ */
+typedef struct appender_chunk_s
+{
+	struct appender_chunk_s *next;
+	size_t len;
+	size_t mark;
+	char data[APPENDER_CHUNK];
+} appender_chunk_t;
+
+/**
+ * struct appender_s - File kept open for buffered appends
+ * @fd: file opened with O_APPEND
+ * @max_bytes: buffered bytes that trigger a flush
+ * @flush_ms: age of the oldest buffered record that triggers a flush,
+ *            0 to flush on size and explicit calls only
+ * @sync: nonzero to make every append durable before returning
+ * @lock: protects everything below
+ * @io_lock: serializes flushes so records reach the file in order
+ * @kick: wakes the flusher thread
+ * @synced: signalled when a group commit ends
+ * @head: first buffered block
+ * @tail: last buffered block
+ * @spare: blocks kept for reuse
+ * @pending: buffered bytes
+ * @since: when the oldest buffered record was added (CLOCK_MONOTONIC)
+ * @appended: number of records appended so far
+ * @durable: number of records known to be on stable storage
+ * @syncing: nonzero while a thread leads a group commit
+ * @failed: nonzero once a write or fdatasync failed
+ * @closing: nonzero once appender_close started
+ * @flusher: thread flushing on @flush_ms
+ */
+typedef struct appender_s
+{
+	int fd;
+	size_t max_bytes;
+	long flush_ms;
+	int sync;
+	pthread_mutex_t lock;
+	pthread_mutex_t io_lock;
+	pthread_cond_t kick;
+	pthread_cond_t synced;
+	appender_chunk_t *head;
+	appender_chunk_t *tail;
+	appender_chunk_t *spare;
+	size_t pending;
+	struct timespec since;
+	unsigned long appended;
+	unsigned long durable;
+	int syncing;
+	int failed;
+	int closing;
+	pthread_t flusher;
+} appender_t;
+
+/* 103-appender.c */
+appender_t *appender_open(const char *filename, size_t max_bytes,
+			  long flush_ms, int sync);
+int appender_append(appender_t *ap, const char *text_content);
+int appender_close(appender_t *ap);
+
+/* 103-appender_flush.c */
+int appender_flush(appender_t *ap);
+int appender_sync(appender_t *ap);
+void *appender_flusher(void *arg);
+
+/* 103-appender_write.c */
+int appender_writev(int fd, appender_chunk_t *c);
+
+#endif
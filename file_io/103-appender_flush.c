@@ -0,0 +1,121 @@
+#include "103-appender.h"
+#include <errno.h>
+
+/**
+ * appender_flush - Writes every buffered record of an appender.
+ * @ap: The appender.
+ *
+ * Description: The buffered blocks are detached under the lock, so other
+ * threads keep appending while they are written; io_lock keeps flushes,
+ * and thus records, in order.
+ * Return: -1 if this or an earlier write failed, 1 otherwise.
+ */
+int appender_flush(appender_t *ap)
+{
+	appender_chunk_t *list, *last;
+	int r = 1;
+
+	pthread_mutex_lock(&ap->io_lock);
+	pthread_mutex_lock(&ap->lock);
+	list = ap->head;
+	last = ap->tail;
+	ap->head = ap->tail = NULL;
+	ap->pending = 0;
+	pthread_mutex_unlock(&ap->lock);
+
+	if (list != NULL)
+		r = appender_writev(ap->fd, list);
+
+	pthread_mutex_lock(&ap->lock);
+	if (r == -1)
+		ap->failed = 1;
+	if (list != NULL)
+	{
+		last->next = ap->spare;
+		ap->spare = list;
+	}
+	r = ap->failed ? -1 : 1;
+	pthread_mutex_unlock(&ap->lock);
+	pthread_mutex_unlock(&ap->io_lock);
+
+	return (r);
+}
+
+/**
+ * appender_sync - Makes every record appended so far durable.
+ * @ap: The appender.
+ *
+ * Description: Group commit: one caller flushes and runs fdatasync for
+ * all records appended before it started, while concurrent callers wait
+ * for that commit, or lead the next one, instead of issuing their own.
+ * Return: -1 on failure, 1 otherwise.
+ */
+int appender_sync(appender_t *ap)
+{
+	unsigned long mine, target;
+	int r;
+
+	pthread_mutex_lock(&ap->lock);
+	mine = ap->appended;
+	while (ap->durable < mine && !ap->failed)
+	{
+		if (ap->syncing)
+		{
+			pthread_cond_wait(&ap->synced, &ap->lock);
+			continue;
+		}
+		ap->syncing = 1;
+		target = ap->appended;
+		pthread_mutex_unlock(&ap->lock);
+		r = appender_flush(ap);
+		if (r == 1 && fdatasync(ap->fd) == -1)
+			r = -1;
+		pthread_mutex_lock(&ap->lock);
+		ap->syncing = 0;
+		if (r == -1)
+			ap->failed = 1;
+		else
+			ap->durable = target;
+		pthread_cond_broadcast(&ap->synced);
+	}
+	r = ap->failed ? -1 : 1;
+	pthread_mutex_unlock(&ap->lock);
+
+	return (r);
+}
+
+/**
+ * appender_flusher - Flushes records once the oldest is flush_ms old.
+ * @arg: The appender.
+ *
+ * Return: NULL.
+ */
+void *appender_flusher(void *arg)
+{
+	appender_t *ap = arg;
+	struct timespec deadline;
+
+	pthread_mutex_lock(&ap->lock);
+	while (!ap->closing)
+	{
+		if (ap->pending == 0)
+		{
+			pthread_cond_wait(&ap->kick, &ap->lock);
+			continue;
+		}
+		deadline = ap->since;
+		deadline.tv_sec += ap->flush_ms / 1000;
+		deadline.tv_nsec += (ap->flush_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+			deadline.tv_sec++, deadline.tv_nsec -= 1000000000L;
+		if (pthread_cond_timedwait(&ap->kick, &ap->lock, &deadline) !=
+		    ETIMEDOUT || ap->pending == 0)
+			continue;
+		pthread_mutex_unlock(&ap->lock);
+		appender_flush(ap);
+		pthread_mutex_lock(&ap->lock);
+	}
+	pthread_mutex_unlock(&ap->lock);
+
+	return (NULL);
+}
@@ -0,0 +1,104 @@
+#include "103-appender.h"
+#include <string.h>
+
+/**
+ * appender_batch - Gathers the whole records one writev can take.
+ * @c: The block to start from, moved past the gathered bytes.
+ * @off: The offset to start from in *@c, moved along with it.
+ * @iov: Filled with up to APPENDER_IOV buffers.
+ *
+ * Description: The batch ends at the last record end it holds, so no
+ * record is split between two writev calls.
+ * Return: The number of buffers, 0 if the record at *@c does not fit.
+ */
+static int appender_batch(appender_chunk_t **c, size_t *off,
+			  struct iovec *iov)
+{
+	appender_chunk_t *p = *c, *cut = NULL;
+	size_t start;
+	int n, ncut = 0;
+
+	for (n = 0; p != NULL && n < APPENDER_IOV; p = p->next, n++)
+	{
+		start = n == 0 ? *off : 0;
+		iov[n].iov_base = p->data + start;
+		iov[n].iov_len = p->len - start;
+		if (p->mark > start)
+			cut = p, ncut = n;
+	}
+	if (p == NULL)
+	{
+		*c = NULL;
+		return (n);
+	}
+	if (cut == NULL)
+		return (0);
+	iov[ncut].iov_len = cut->mark - (ncut == 0 ? *off : 0);
+	*c = cut->mark == cut->len ? cut->next : cut;
+	*off = cut->mark == cut->len ? 0 : cut->mark;
+
+	return (ncut + 1);
+}
+
+/**
+ * appender_write_record - Writes a record too large for one writev.
+ * @fd: The file descriptor.
+ * @c: The block the record starts in, moved past it.
+ * @off: The offset the record starts at in *@c, moved along with it.
+ *
+ * Description: The record, up to the last record end of the block it
+ * ends in, is copied into one buffer and written by a single write.
+ * Return: 1 on success, -1 on failure.
+ */
+static int appender_write_record(int fd, appender_chunk_t **c, size_t *off)
+{
+	appender_chunk_t *p = *c, *q;
+	size_t len = p->len - *off;
+	char *buf, *dst;
+	ssize_t w;
+
+	for (q = p->next; q->mark == 0; q = q->next)
+		len += q->len;
+	len += q->mark;
+	buf = malloc(len);
+	if (buf == NULL)
+		return (-1);
+	memcpy(buf, p->data + *off, p->len - *off);
+	dst = buf + p->len - *off;
+	for (p = p->next; p != q; p = p->next)
+		memcpy(dst, p->data, p->len), dst += p->len;
+	memcpy(dst, q->data, q->mark);
+	w = write_all(fd, buf, len);
+	free(buf);
+	*c = q->mark == q->len ? q->next : q;
+	*off = q->mark == q->len ? 0 : q->mark;
+
+	return (w == -1 ? -1 : 1);
+}
+
+/**
+ * appender_writev - Writes a list of blocks with as few writev as possible.
+ * @fd: The file descriptor.
+ * @c: The first block, the list ending with a whole record.
+ *
+ * Description: Each record reaches the file through a single writev or
+ * write, so it stays in one piece among other O_APPEND writers.
+ * Return: 1 on success, -1 on failure.
+ */
+int appender_writev(int fd, appender_chunk_t *c)
+{
+	struct iovec iov[APPENDER_IOV];
+	size_t off = 0;
+	int n;
+
+	while (c != NULL)
+	{
+		n = appender_batch(&c, &off, iov);
+		if (n == 0 && appender_write_record(fd, &c, &off) == -1)
+			return (-1);
+		if (n > 0 && writev_all(fd, iov, n) == -1)
+			return (-1);
+	}
+
+	return (1);
+}
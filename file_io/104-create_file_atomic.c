@@ -0,0 +1,270 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <errno.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+/* Bytes of the target's name kept in a temporary name, so that the dot,
+ * pid and sequence number around it fit in NAME_MAX
+ */
+#define ATOMIC_BASE_MAX (NAME_MAX - 32)
+
+/**
+ * struct atomic_dir_s - Directory whose entries changed in a batch
+ * @dev: device of the directory
+ * @ino: inode of the directory
+ * @fd: descriptor kept open to fsync it
+ */
+typedef struct atomic_dir_s
+{
+	dev_t dev;
+	ino_t ino;
+	int fd;
+} atomic_dir_t;
+
+/**
+ * atomic_parent - Opens the directory a file lives in.
+ * @filename: The name of the file.
+ * @path: Set to @filename with its symbolic links resolved, to be freed
+ *        by the caller, or to a copy of it if it does not exist yet.
+ * @base: Set to the last component of @path.
+ *
+ * Description: Resolving the links first makes the rename replace the
+ * file a symbolic link points to, as create_file writes through it,
+ * instead of the link itself. A dangling link still gets replaced.
+ * Return: The directory descriptor, -1 on failure.
+ */
+static int atomic_parent(const char *filename, char **path,
+			 const char **base)
+{
+	char *slash;
+	int d;
+
+	*path = realpath(filename, NULL);
+	if (*path == NULL)
+		*path = strdup(filename);
+	if (*path == NULL)
+		return (-1);
+	slash = strrchr(*path, '/');
+	*base = slash ? slash + 1 : *path;
+	if (slash == NULL)
+		return (open(".", O_RDONLY | O_DIRECTORY));
+	if (slash == *path)
+		return (open("/", O_RDONLY | O_DIRECTORY));
+	*slash = '\0';
+	d = open(*path, O_RDONLY | O_DIRECTORY);
+	*slash = '/';
+
+	return (d);
+}
+
+/**
+ * atomic_temp - Gives a temporary file a unique name next to its target.
+ * @dir: The directory descriptor.
+ * @base: The name of the target, cut to ATOMIC_BASE_MAX bytes in the
+ *        temporary name so that it stays within NAME_MAX.
+ * @tmp: Buffer of NAME_MAX + 1 bytes receiving the temporary name, left
+ *       empty on failure.
+ * @fd: An unnamed O_TMPFILE file to link, or -1 to create a new file.
+ *
+ * Description: The unnamed file is linked with AT_EMPTY_PATH, which
+ * needs CAP_DAC_READ_SEARCH, else through /proc/self/fd.
+ * Return: The named file's descriptor, -1 on failure.
+ */
+static int atomic_temp(int dir, const char *base, char *tmp, int fd)
+{
+	static unsigned int seq;
+	char proc[32];
+	int r;
+
+	sprintf(proc, "/proc/self/fd/%d", fd);
+	do {
+		sprintf(tmp, ".%.*s.%ld.%u", ATOMIC_BASE_MAX, base,
+			(long)getpid(), __sync_fetch_and_add(&seq, 1));
+		if (fd == -1)
+			r = openat(dir, tmp, O_CREAT | O_EXCL | O_WRONLY, 0600);
+		else if (linkat(fd, "", dir, tmp, AT_EMPTY_PATH) == 0 ||
+			 (errno != EEXIST && linkat(AT_FDCWD, proc, dir, tmp,
+						    AT_SYMLINK_FOLLOW) == 0))
+			r = fd;
+		else
+			r = -1;
+	} while (r == -1 && errno == EEXIST);
+	if (r == -1)
+		*tmp = '\0';
+
+	return (r);
+}
+
+/**
+ * atomic_fill - Writes the contents of a temporary file.
+ * @f: The temporary file.
+ * @dir: The directory descriptor.
+ * @base: The name of the file being replaced, whose mode is kept.
+ * @text: The NULL terminated contents, NULL for an empty file.
+ * @durable: Nonzero to fdatasync the contents.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+static int atomic_fill(int f, int dir, const char *base, const char *text,
+		       int durable)
+{
+	struct stat st;
+
+	if (fstatat(dir, base, &st, 0) == 0 && fchmod(f, st.st_mode & 07777))
+		return (-1);
+	if (text != NULL && write_all(f, text, strlen(text)) == -1)
+		return (-1);
+	if (durable && fdatasync(f) == -1)
+		return (-1);
+
+	return (1);
+}
+
+/**
+ * atomic_replace - Writes a file's new contents and renames it in place.
+ * @dir: The directory descriptor.
+ * @base: The name of the file in @dir.
+ * @text: The NULL terminated contents, NULL for an empty file.
+ * @durable: Nonzero to fdatasync the contents before the rename.
+ *
+ * Description: The contents go to an O_TMPFILE file, which only gets a
+ * name once complete. Where the filesystem lacks O_TMPFILE, or the file
+ * cannot be linked (no CAP_DAC_READ_SEARCH and no /proc), they go to a
+ * named temporary file instead. Readers see either the old file or the
+ * new one.
+ * Return: 1 on success, -1 otherwise.
+ */
+static int atomic_replace(int dir, const char *base, const char *text,
+			  int durable)
+{
+	char tmp[NAME_MAX + 1];
+	int f, r = 0;
+
+	*tmp = '\0';
+	f = openat(dir, ".", O_TMPFILE | O_WRONLY, 0600);
+	if (f != -1)
+	{
+		r = atomic_fill(f, dir, base, text, durable);
+		if (r == 1 && atomic_temp(dir, base, tmp, f) == -1)
+			r = 0;
+		close(f);
+	}
+	if (r == 0)
+	{
+		f = atomic_temp(dir, base, tmp, -1);
+		r = f == -1 ? -1 : atomic_fill(f, dir, base, text, durable);
+		if (f != -1 && close(f) == -1)
+			r = -1;
+	}
+	if (r == 1)
+		r = renameat(dir, tmp, dir, base) == 0 ? 1 : -1;
+	if (r == -1 && *tmp != '\0')
+		unlinkat(dir, tmp, 0);
+
+	return (r);
+}
+
+/**
+ * atomic_sync_later - Keeps a directory to fsync once a batch is done.
+ * @dirs: The directories kept so far.
+ * @ndirs: Their number, increased if @d is kept.
+ * @d: The directory descriptor, closed unless kept.
+ *
+ * Description: A directory already kept is not kept twice. One that
+ * cannot be identified is fsynced right away.
+ * Return: 1 on success, -1 if fsync failed.
+ */
+static int atomic_sync_later(atomic_dir_t *dirs, size_t *ndirs, int d)
+{
+	struct stat st;
+	size_t j;
+	int r = 1;
+
+	if (fstat(d, &st) == -1)
+	{
+		r = fsync(d) == -1 ? -1 : 1;
+		close(d);
+		return (r);
+	}
+	for (j = 0; j < *ndirs; j++)
+	{
+		if (dirs[j].dev == st.st_dev && dirs[j].ino == st.st_ino)
+		{
+			close(d);
+			return (1);
+		}
+	}
+	dirs[*ndirs].dev = st.st_dev, dirs[*ndirs].ino = st.st_ino;
+	dirs[(*ndirs)++].fd = d;
+
+	return (1);
+}
+
+/**
+ * create_files_atomic - Creates or replaces many files atomically.
+ * @filenames: The names of the files.
+ * @text_contents: The NULL terminated contents of each file.
+ * @n: The number of files.
+ * @durable: Nonzero to make the files survive a crash once this returns.
+ *
+ * Description: Each file is replaced as by create_file_atomic, but in
+ * durable mode each parent directory is fsynced once, after every rename
+ * into it, instead of once per file.
+ * Return: 1 if every file was written, -1 otherwise.
+ */
+int create_files_atomic(const char **filenames, char **text_contents,
+			size_t n, int durable)
+{
+	atomic_dir_t *dirs = durable ? malloc(sizeof(atomic_dir_t) * n) : NULL;
+	size_t i, ndirs = 0;
+	const char *base;
+	char *path;
+	int d, r = 1;
+
+	if (filenames == NULL || (durable && n > 0 && dirs == NULL))
+		return (-1);
+	for (i = 0; i < n; i++)
+	{
+		path = NULL;
+		d = -1;
+		if (filenames[i] != NULL)
+			d = atomic_parent(filenames[i], &path, &base);
+		if (d == -1 || atomic_replace(d, base, text_contents ?
+		    text_contents[i] : NULL, durable) == -1)
+			r = -1;
+		free(path);
+		if (d != -1 && !durable)
+			close(d);
+		else if (d != -1 && atomic_sync_later(dirs, &ndirs, d) == -1)
+			r = -1;
+	}
+	for (i = 0; i < ndirs; i++)
+	{
+		if (fsync(dirs[i].fd) == -1)
+			r = -1;
+		close(dirs[i].fd);
+	}
+	free(dirs);
+
+	return (r);
+}
+
+/**
+ * create_file_atomic - Creates or replaces a file atomically.
+ * @filename: The name of the file to create.
+ * @text_content: A NULL terminated string to write to the file.
+ * @durable: Nonzero to fdatasync the file and fsync its directory.
+ *
+ * Description: Unlike create_file, readers never see a truncated or
+ * half-written file, and a crash leaves the old contents in place. Like
+ * create_file, a symbolic link is written through: the file it points
+ * to is replaced and the link kept.
+ * Return: 1 on success, -1 otherwise.
+ */
+int create_file_atomic(const char *filename, char *text_content,
+		       int durable)
+{
+	return (create_files_atomic(&filename, &text_content, 1, durable));
+}
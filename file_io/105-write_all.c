@@ -0,0 +1,77 @@
+#include "main.h"
+#include <errno.h>
+
+/**
+ * write_all - Writes a whole buffer to a file descriptor.
+ * @fd: The file descriptor.
+ * @buf: The bytes to write.
+ * @len: The number of bytes.
+ *
+ * Description: Partial writes and writes interrupted by a signal
+ * are retried until every byte is written or an error occurs.
+ * Return: @len on success, -1 otherwise.
+ */
+ssize_t write_all(int fd, const void *buf, size_t len)
+{
+	size_t done = 0;
+	ssize_t w;
+
+	while (done < len)
+	{
+		w = write(fd, (const char *)buf + done, len - done);
+		if (w == -1 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			return (-1);
+		done += w;
+	}
+
+	return (len);
+}
+
+/**
+ * writev_all - Writes a whole iovec array to a file descriptor.
+ * @fd: The file descriptor.
+ * @iov: The buffers to write, in order. They are not modified.
+ * @iovcnt: The number of buffers.
+ *
+ * Description: Buffers are handed to writev WRITE_IOV at a time; after a
+ * partial write the next call resumes inside the buffer it stopped in.
+ * Return: The number of bytes written, -1 on error.
+ */
+ssize_t writev_all(int fd, const struct iovec *iov, int iovcnt)
+{
+	struct iovec v[WRITE_IOV];
+	ssize_t w, total = 0;
+	int i, n;
+
+	while (iovcnt > 0)
+	{
+		n = iovcnt < WRITE_IOV ? iovcnt : WRITE_IOV;
+		for (i = 0; i < n; i++)
+			v[i] = iov[i], total += iov[i].iov_len;
+		iov += n, iovcnt -= n;
+		for (i = 0; i < n;)
+		{
+			if (v[i].iov_len == 0)
+			{
+				i++;
+				continue;
+			}
+			w = writev(fd, v + i, n - i);
+			if (w == -1 && errno == EINTR)
+				continue;
+			if (w <= 0)
+				return (-1);
+			for (; i < n && (size_t)w >= v[i].iov_len; i++)
+				w -= v[i].iov_len;
+			if (i < n)
+			{
+				v[i].iov_base = (char *)v[i].iov_base + w;
+				v[i].iov_len -= w;
+			}
+		}
+	}
+
+	return (total);
+}
@@ -0,0 +1,99 @@
+#include "main.h"
+
+/**
+ * write_file_iov - Opens a file and writes an iovec array to it.
+ * @filename: The name of the file.
+ * @flags: The open flags.
+ * @iov: The buffers to write.
+ * @iovcnt: The number of buffers.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+static int write_file_iov(const char *filename, int flags,
+			  const struct iovec *iov, int iovcnt)
+{
+	int f, r = 1;
+
+	if (filename == NULL || iovcnt < 0 || (iov == NULL && iovcnt > 0))
+		return (-1);
+
+	f = open(filename, flags, 0600);
+	if (f == -1)
+		return (-1);
+	if (writev_all(f, iov, iovcnt) == -1)
+		r = -1;
+	if (close(f) == -1)
+		r = -1;
+
+	return (r);
+}
+
+/**
+ * create_file_iov - Creates a file from an array of buffers.
+ * @filename: The name of the file to create.
+ * @iov: The buffers holding the contents, in order.
+ * @iovcnt: The number of buffers.
+ *
+ * Description: Same semantics as create_file, but the contents need not
+ * be contiguous nor NUL terminated, and every byte is written.
+ * Return: 1 on success, -1 otherwise.
+ */
+int create_file_iov(const char *filename, const struct iovec *iov,
+		    int iovcnt)
+{
+	return (write_file_iov(filename, O_CREAT | O_WRONLY | O_TRUNC,
+			       iov, iovcnt));
+}
+
+/**
+ * create_file_len - Creates a file from a buffer of known length.
+ * @filename: The name of the file to create.
+ * @buf: The contents, may be NULL if @len is 0.
+ * @len: The number of bytes in @buf.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+int create_file_len(const char *filename, const void *buf, size_t len)
+{
+	struct iovec v;
+
+	v.iov_base = (void *)buf;
+	v.iov_len = len;
+
+	return (create_file_iov(filename, &v, len > 0));
+}
+
+/**
+ * append_text_to_file_iov - Appends an array of buffers to a file.
+ * @filename: The name of the file, which must already exist.
+ * @iov: The buffers to append, in order.
+ * @iovcnt: The number of buffers.
+ *
+ * Description: Same semantics as append_text_to_file, but every byte is
+ * written, with as few writev calls as the kernel allows.
+ * Return: 1 on success, -1 otherwise.
+ */
+int append_text_to_file_iov(const char *filename, const struct iovec *iov,
+			    int iovcnt)
+{
+	return (write_file_iov(filename, O_WRONLY | O_APPEND, iov, iovcnt));
+}
+
+/**
+ * append_text_to_file_len - Appends a buffer of known length to a file.
+ * @filename: The name of the file, which must already exist.
+ * @buf: The bytes to append, may be NULL if @len is 0.
+ * @len: The number of bytes in @buf.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+int append_text_to_file_len(const char *filename, const void *buf,
+			    size_t len)
+{
+	struct iovec v;
+
+	v.iov_base = (void *)buf;
+	v.iov_len = len;
+
+	return (append_text_to_file_iov(filename, &v, len > 0));
+}
@@ -0,0 +1,127 @@
+#include "106-fio.h"
+
+/**
+ * fio_create - Starts a context running file operations.
+ * @nthreads: The most pool threads, 0 for FIO_THREADS.
+ *
+ * Description: Reads, creations and appends run on an io_uring driven by
+ * one thread, so up to FIO_RING of them are in flight at once with one
+ * io_uring_enter per batch. Copies, and everything when the kernel has
+ * no usable io_uring, run on a pool of threads started as the queued
+ * work needs them.
+ * Return: The context, or NULL on failure.
+ */
+fio_ctx_t *fio_create(int nthreads)
+{
+	fio_ctx_t *ctx;
+
+	ctx = calloc(1, sizeof(fio_ctx_t));
+	if (ctx == NULL)
+		return (NULL);
+	ctx->maxthreads = nthreads > 0 ? nthreads : FIO_THREADS;
+	ctx->threads = malloc(sizeof(pthread_t) * ctx->maxthreads);
+	if (ctx->threads == NULL)
+	{
+		free(ctx);
+		return (NULL);
+	}
+	pthread_mutex_init(&ctx->lock, NULL);
+	pthread_cond_init(&ctx->work, NULL);
+	pthread_cond_init(&ctx->ready, NULL);
+	if (fio_spawn(ctx) == -1)
+	{
+		fio_destroy(ctx);
+		return (NULL);
+	}
+	fio_uring_start(ctx);
+
+	return (ctx);
+}
+
+/**
+ * fio_submit - Queues a request without waiting for it.
+ * @ctx: The context.
+ * @req: The request, with op and its arguments set.
+ *
+ * Return: 1 on success, -1 if the context is stopping.
+ */
+int fio_submit(fio_ctx_t *ctx, fio_req_t *req)
+{
+	if (ctx == NULL || req == NULL)
+		return (-1);
+	req->next = NULL;
+	req->data = NULL;
+	req->size = 0;
+	req->result = -1;
+	req->error = 0;
+	req->stage = FIO_OPEN;
+
+	pthread_mutex_lock(&ctx->lock);
+	if (ctx->stop)
+	{
+		pthread_mutex_unlock(&ctx->lock);
+		return (-1);
+	}
+	ctx->inflight++;
+	fio_enqueue(ctx, req);
+	pthread_mutex_unlock(&ctx->lock);
+
+	return (1);
+}
+
+/**
+ * fio_complete - Reaps a completed request.
+ * @ctx: The context.
+ * @wait: Nonzero to block until a request without callback completes.
+ *
+ * Return: The completed request, or NULL if none is ready (or, when
+ *         waiting, none is in flight).
+ */
+fio_req_t *fio_complete(fio_ctx_t *ctx, int wait)
+{
+	fio_req_t *req;
+
+	pthread_mutex_lock(&ctx->lock);
+	while (ctx->cq_head == NULL && wait && ctx->inflight > 0)
+		pthread_cond_wait(&ctx->ready, &ctx->lock);
+	req = ctx->cq_head;
+	if (req != NULL)
+		ctx->cq_head = req->next;
+	if (ctx->cq_head == NULL)
+		ctx->cq_tail = NULL;
+	pthread_mutex_unlock(&ctx->lock);
+
+	if (req != NULL)
+		req->next = NULL;
+	return (req);
+}
+
+/**
+ * fio_destroy - Finishes every submitted request and stops the context.
+ * @ctx: The context. Completed requests not yet reaped are dropped.
+ */
+void fio_destroy(fio_ctx_t *ctx)
+{
+	int i;
+
+	if (ctx == NULL)
+		return;
+	pthread_mutex_lock(&ctx->lock);
+	ctx->stop = 1;
+	pthread_cond_broadcast(&ctx->work);
+	if (ctx->ring != NULL)
+		fio_uring_wake(ctx->ring);
+	pthread_mutex_unlock(&ctx->lock);
+	if (ctx->ring != NULL)
+		pthread_join(ctx->ring->thread, NULL);
+	for (i = 0; i < ctx->nthreads; i++)
+		pthread_join(ctx->threads[i], NULL);
+	if (ctx->ring != NULL)
+		fio_ring_close(ctx->ring);
+
+	pthread_cond_destroy(&ctx->ready);
+	pthread_cond_destroy(&ctx->work);
+	pthread_mutex_destroy(&ctx->lock);
+	free(ctx->threads);
+	free(ctx);
+}
@@ -0,0 +1,207 @@
+#ifndef FIO_H
+#define FIO_H
+
+#include "main.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+/* Most worker threads started on demand when fio_create is given 0 */
+#define FIO_THREADS 64
+/* Submission queue entries of the io_uring, one per request in flight */
+#define FIO_RING 256
+/* Most bytes asked of one IORING_OP_READ or IORING_OP_WRITE */
+#define FIO_CHUNK (1U << 30)
+
+/* Steps of a request on the io_uring, fio_req_t.stage */
+#define FIO_OPEN 0
+#define FIO_IO 1
+#define FIO_CLOSE 2
+/* Finished on the ring, callback left to run on the pool */
+#define FIO_DONE 3
+
+/**
+ * enum fio_op_e - File operations run asynchronously
+ * @FIO_READ: read a whole file into memory, as read_textfile would
+ * @FIO_CREATE: create or truncate a file, as create_file would
+ * @FIO_APPEND: append to an existing file, as append_text_to_file would
+ * @FIO_COPY: copy a file, as the cp tool would
+ */
+typedef enum fio_op_e
+{
+	FIO_READ,
+	FIO_CREATE,
+	FIO_APPEND,
+	FIO_COPY
+} fio_op_t;
+
+/**
+ * struct fio_req_s - One asynchronous file operation
+ * @op: operation to run
+ * @path: file read, created or appended to, source of a copy
+ * @to: destination of a copy
+ * @buf: contents written by FIO_CREATE and FIO_APPEND
+ * @len: number of bytes in @buf
+ * @data: FIO_READ result, NUL terminated, freed by the caller
+ * @size: number of bytes in @data
+ * @result: 1 on success, -1 on failure
+ * @error: errno of the failure, 0 on success
+ * @done: called by a pool thread on completion, or NULL to have the
+ *        request returned by fio_complete
+ * @arg: opaque pointer for @done
+ * @next: link in the context's queues
+ * @prev: io_uring backend, link in the list of running requests
+ * @stage: step the request is waiting on
+ * @fd: io_uring backend, file being read or written, -1 if none
+ * @off: io_uring backend, bytes read or written so far
+ * @cap: io_uring backend, size of @data
+ *
+ * Description: The caller owns the request and the memory it points to
+ * until it completes. The last five fields are private to the context.
+ */
+typedef struct fio_req_s
+{
+	fio_op_t op;
+	const char *path;
+	const char *to;
+	const void *buf;
+	size_t len;
+	char *data;
+	size_t size;
+	int result;
+	int error;
+	void (*done)(struct fio_req_s *req);
+	void *arg;
+	struct fio_req_s *next;
+	struct fio_req_s *prev;
+	int stage;
+	int fd;
+	size_t off;
+	size_t cap;
+} fio_req_t;
+
+/**
+ * struct fio_ring_s - io_uring set up with raw syscalls
+ * @fd: ring file descriptor
+ * @wake: eventfd read by the ring, written by fio_submit and fio_destroy
+ * @count: value read from @wake
+ * @sq_ptr: mapping of the submission ring
+ * @cq_ptr: mapping of the completion ring, may be @sq_ptr
+ * @sq_len: size of the @sq_ptr mapping
+ * @cq_len: size of the @cq_ptr mapping, 0 if shared with @sq_ptr
+ * @sqes: submission queue entries
+ * @sq_tail: kernel-shared tail of the submission ring
+ * @sq_mask: index mask of the submission ring
+ * @sq_array: submission ring, indexes into @sqes
+ * @sq_entries: number of entries of the submission ring
+ * @cq_head: kernel-shared head of the completion ring
+ * @cq_tail: kernel-shared tail of the completion ring
+ * @cq_mask: index mask of the completion ring
+ * @cqes: completion ring
+ * @queued: entries written since the last io_uring_enter
+ * @active: requests with an entry in flight, @wake excluded
+ * @running: list of those requests, linked through next and prev
+ * @done: set under the context's lock once the ring thread stopped
+ *        taking requests, when the context stops or the ring fails
+ * @thread: thread driving the ring
+ */
+typedef struct fio_ring_s
+{
+	int fd;
+	int wake;
+	uint64_t count;
+	void *sq_ptr;
+	void *cq_ptr;
+	size_t sq_len;
+	size_t cq_len;
+	struct io_uring_sqe *sqes;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+	unsigned int sq_entries;
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+	unsigned int queued;
+	unsigned int active;
+	struct fio_req_s *running;
+	int done;
+	pthread_t thread;
+} fio_ring_t;
+
+/**
+ * struct fio_ctx_s - io_uring and pool of threads running file operations
+ * @lock: protects the queues and counters
+ * @work: signalled when a request is queued for the pool or it stops
+ * @ready: signalled when a request completes
+ * @sq_head: first request queued for the pool, not yet started
+ * @sq_tail: last request queued for the pool, not yet started
+ * @rq_head: first request queued for the ring, not yet started
+ * @rq_tail: last request queued for the ring, not yet started
+ * @cq_head: first completed request not yet reaped
+ * @cq_tail: last completed request not yet reaped
+ * @inflight: requests submitted and not yet completed
+ * @queued: requests in the pool's queue
+ * @idle: pool threads waiting for a request
+ * @stop: nonzero once fio_destroy started
+ * @nthreads: number of pool threads started so far
+ * @maxthreads: most pool threads, size of @threads
+ * @threads: pool thread handles
+ * @ring: io_uring backend, NULL if the kernel does not provide it
+ */
+typedef struct fio_ctx_s
+{
+	pthread_mutex_t lock;
+	pthread_cond_t work;
+	pthread_cond_t ready;
+	fio_req_t *sq_head;
+	fio_req_t *sq_tail;
+	fio_req_t *rq_head;
+	fio_req_t *rq_tail;
+	fio_req_t *cq_head;
+	fio_req_t *cq_tail;
+	size_t inflight;
+	size_t queued;
+	int idle;
+	int stop;
+	int nthreads;
+	int maxthreads;
+	pthread_t *threads;
+	fio_ring_t *ring;
+} fio_ctx_t;
+
+/* 106-fio.c */
+fio_ctx_t *fio_create(int nthreads);
+int fio_submit(fio_ctx_t *ctx, fio_req_t *req);
+fio_req_t *fio_complete(fio_ctx_t *ctx, int wait);
+void fio_destroy(fio_ctx_t *ctx);
+
+/* 106-fio_queue.c */
+int fio_spawn(fio_ctx_t *ctx);
+void fio_enqueue(fio_ctx_t *ctx, fio_req_t *req);
+void fio_finish(fio_ctx_t *ctx, fio_req_t *req);
+void fio_done(fio_ctx_t *ctx, fio_req_t *req);
+
+/* 106-fio_ops.c */
+void fio_run(fio_req_t *req);
+int fio_read_alloc(fio_req_t *req, int fd);
+int fio_read_room(fio_req_t *req);
+
+/* 106-fio_ring.c */
+fio_ring_t *fio_ring_open(void);
+void fio_ring_close(fio_ring_t *ring);
+struct io_uring_sqe *fio_ring_sqe(fio_ring_t *ring, int op, int fd,
+				  void *user);
+int fio_ring_enter(fio_ring_t *ring, unsigned int wait);
+
+/* 106-fio_step.c */
+void fio_uring_step(fio_ring_t *ring, fio_req_t *req);
+int fio_uring_next(fio_req_t *req, int res);
+void fio_uring_fail(fio_ctx_t *ctx, int error);
+
+/* 106-fio_uring.c */
+int fio_uring_start(fio_ctx_t *ctx);
+int fio_uring_wake(fio_ring_t *ring);
+
+#endif
@@ -0,0 +1,149 @@
+#include "3-cp.h"
+#include "106-fio.h"
+#include <errno.h>
+
+/**
+ * fio_read_alloc - Allocates the buffer of a FIO_READ request.
+ * @req: The request, its data and cap are set.
+ * @fd: The file being read.
+ *
+ * Description: The buffer holds the size fstat reports plus a spare
+ * byte. The read that finds EOF lands in that byte, so a file that does
+ * not change while it is read is never reallocated; files that grow or
+ * report a zero size (procfs) make fio_read_room double it.
+ * Return: 1 on success, -1 otherwise.
+ */
+int fio_read_alloc(fio_req_t *req, int fd)
+{
+	struct stat st;
+
+	req->cap = 4096;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		req->cap = (size_t)st.st_size + 1;
+	req->data = malloc(req->cap);
+
+	return (req->data == NULL ? -1 : 1);
+}
+
+/**
+ * fio_read_room - Makes room for the next read of a FIO_READ request.
+ * @req: The request.
+ *
+ * Description: Grows the buffer only once the last read filled it, the
+ * spare byte included, which means the file held more than announced.
+ * Return: 1 on success, -1 otherwise.
+ */
+int fio_read_room(fio_req_t *req)
+{
+	char *tmp;
+
+	if (req->size < req->cap)
+		return (1);
+	tmp = realloc(req->data, req->cap * 2);
+	if (tmp == NULL)
+		return (-1);
+	req->data = tmp;
+	req->cap *= 2;
+
+	return (1);
+}
+
+/**
+ * fio_read_file - Reads a whole file into a NUL terminated buffer.
+ * @req: The request, its data and size are set on success.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+static int fio_read_file(fio_req_t *req)
+{
+	ssize_t r;
+	int f;
+
+	f = open(req->path, O_RDONLY);
+	if (f == -1)
+		return (-1);
+	r = fio_read_alloc(req, f);
+	while (r > 0)
+	{
+		r = fio_read_room(req);
+		if (r > 0)
+			r = read(f, req->data + req->size,
+				 req->cap - req->size);
+		if (r == -1 && errno == EINTR)
+			r = 1;
+		else if (r > 0)
+			req->size += r;
+	}
+	if (r == -1)
+		req->error = errno;
+	close(f);
+	if (r == -1)
+		return (-1);
+	req->data[req->size] = '\0';
+
+	return (1);
+}
+
+/**
+ * fio_copy - Copies a file with the cp tool's copy engine.
+ * @req: The request.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+static int fio_copy(fio_req_t *req)
+{
+	cp_opts_t opts = {0, 0, 0, CP_SYNC_NONE, 0, CP_SUM_NONE, 0};
+	struct stat st;
+	int from, to, r = -1;
+
+	from = open(req->path, O_RDONLY);
+	if (from == -1)
+		return (-1);
+	to = req->to ? open(req->to, O_WRONLY | O_CREAT | O_TRUNC, 0664) : -1;
+	if (to != -1 && fstat(from, &st) == 0 &&
+	    cp_copy(from, to, &st, &opts, NULL) == CP_DONE)
+		r = 1;
+	if (r == -1)
+		req->error = errno;
+	close(from);
+	if (to != -1 && close(to) == -1 && r == 1)
+		r = -1, req->error = errno;
+
+	return (r);
+}
+
+/**
+ * fio_run - Runs one request on the calling thread.
+ * @req: The request; result and error are set.
+ *
+ * Description: An operation that closes a file after failing records
+ * errno in req->error first, as close may clobber it.
+ */
+void fio_run(fio_req_t *req)
+{
+	errno = 0;
+	req->error = 0;
+	if (req->path == NULL)
+		req->result = -1, errno = EINVAL;
+	else if (req->op == FIO_READ)
+		req->result = fio_read_file(req);
+	else if (req->op == FIO_CREATE)
+		req->result = create_file_len(req->path, req->buf, req->len);
+	else if (req->op == FIO_APPEND)
+		req->result = append_text_to_file_len(req->path, req->buf,
+						      req->len);
+	else if (req->op == FIO_COPY)
+		req->result = fio_copy(req);
+	else
+		req->result = -1, errno = EINVAL;
+	if (req->result == 1)
+		req->error = 0;
+	else if (req->error == 0)
+		req->error = errno;
+	if (req->result == -1 && req->data != NULL)
+	{
+		free(req->data);
+		req->data = NULL;
+		req->size = 0;
+	}
+}
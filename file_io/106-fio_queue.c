@@ -0,0 +1,160 @@
+#include "106-fio.h"
+
+/**
+ * fio_worker - Runs requests queued for the pool until it stops.
+ * @arg: The context.
+ *
+ * Description: Requests the ring finished only have their callback left
+ * to run. The pool outlives the ring thread, which hands it callbacks
+ * until it exits.
+ * Return: NULL.
+ */
+static void *fio_worker(void *arg)
+{
+	fio_ctx_t *ctx = arg;
+	fio_req_t *req;
+
+	pthread_mutex_lock(&ctx->lock);
+	while (ctx->sq_head != NULL || !ctx->stop ||
+	       (ctx->ring != NULL && !ctx->ring->done))
+	{
+		req = ctx->sq_head;
+		if (req == NULL)
+		{
+			ctx->idle++;
+			pthread_cond_wait(&ctx->work, &ctx->lock);
+			ctx->idle--;
+			continue;
+		}
+		ctx->sq_head = req->next;
+		if (ctx->sq_head == NULL)
+			ctx->sq_tail = NULL;
+		ctx->queued--;
+		pthread_mutex_unlock(&ctx->lock);
+
+		req->next = NULL;
+		if (req->stage != FIO_DONE)
+			fio_run(req);
+		fio_finish(ctx, req);
+		pthread_mutex_lock(&ctx->lock);
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return (NULL);
+}
+
+/**
+ * fio_spawn - Starts one more pool thread.
+ * @ctx: The context, locked unless it is being created.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+int fio_spawn(fio_ctx_t *ctx)
+{
+	if (ctx->nthreads == ctx->maxthreads ||
+	    pthread_create(&ctx->threads[ctx->nthreads], NULL, fio_worker,
+			   ctx) != 0)
+		return (-1);
+	ctx->nthreads++;
+
+	return (1);
+}
+
+/**
+ * fio_enqueue - Hands a submitted request to the ring or the pool.
+ * @ctx: The context, locked.
+ * @req: The request.
+ *
+ * Description: Reads, creations and appends go to the io_uring when the
+ * kernel provides it. Copies keep the cp tool's engine, whose
+ * copy_file_range, reflink and sparse paths have no io_uring opcode, so
+ * they go to the pool with everything the ring cannot take. The pool
+ * starts a thread whenever more requests wait than threads are idle, up
+ * to maxthreads, so its concurrency follows the queued work. The ring
+ * thread is woken only when its queue was empty, since it drains the
+ * queue on every pass. Once the ring is done, requests, and callbacks
+ * of requests it finished, all go to the pool.
+ */
+void fio_enqueue(fio_ctx_t *ctx, fio_req_t *req)
+{
+	if (ctx->ring != NULL && !ctx->ring->done && req->stage == FIO_OPEN &&
+	    req->path != NULL &&
+	    (req->op == FIO_READ || req->op == FIO_CREATE ||
+	     req->op == FIO_APPEND) &&
+	    (ctx->rq_tail != NULL || fio_uring_wake(ctx->ring) == 1))
+	{
+		req->stage = FIO_OPEN;
+		req->fd = -1;
+		req->off = 0;
+		if (ctx->rq_tail != NULL)
+			ctx->rq_tail->next = req;
+		else
+			ctx->rq_head = req;
+		ctx->rq_tail = req;
+		return;
+	}
+	if (ctx->sq_tail != NULL)
+		ctx->sq_tail->next = req;
+	else
+		ctx->sq_head = req;
+	ctx->sq_tail = req;
+	ctx->queued++;
+	if (ctx->queued > (size_t)ctx->idle)
+		fio_spawn(ctx);
+	pthread_cond_signal(&ctx->work);
+}
+
+/**
+ * fio_finish - Completes a request run by the pool or the ring.
+ * @ctx: The context, unlocked.
+ * @req: The request. A request with a callback is handed back through
+ *       it and may be freed there, so it is not touched afterwards.
+ */
+void fio_finish(fio_ctx_t *ctx, fio_req_t *req)
+{
+	void (*done)(fio_req_t *req) = req->done;
+
+	if (req->result == -1 && req->data != NULL)
+	{
+		free(req->data);
+		req->data = NULL;
+		req->size = 0;
+	}
+	if (done != NULL)
+		done(req);
+
+	pthread_mutex_lock(&ctx->lock);
+	if (done == NULL)
+	{
+		if (ctx->cq_tail != NULL)
+			ctx->cq_tail->next = req;
+		else
+			ctx->cq_head = req;
+		ctx->cq_tail = req;
+	}
+	ctx->inflight--;
+	pthread_cond_broadcast(&ctx->ready);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+/**
+ * fio_done - Completes a request the ring finished.
+ * @ctx: The context, unlocked.
+ * @req: The request.
+ *
+ * Description: A request reaped with fio_complete is queued right away.
+ * A callback is handed to the pool instead of running on the ring
+ * thread, so a slow one does not hold up every other request.
+ */
+void fio_done(fio_ctx_t *ctx, fio_req_t *req)
+{
+	if (req->done == NULL)
+	{
+		fio_finish(ctx, req);
+		return;
+	}
+	pthread_mutex_lock(&ctx->lock);
+	req->stage = FIO_DONE;
+	fio_enqueue(ctx, req);
+	pthread_mutex_unlock(&ctx->lock);
+}
@@ -0,0 +1,168 @@
+#include "106-fio.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+
+/**
+ * fio_ring_map - Maps the rings of an io_uring into memory.
+ * @ring: The ring, whose fd is set up.
+ * @p: The parameters io_uring_setup filled in.
+ *
+ * Return: 1 on success, -1 otherwise.
+ */
+static int fio_ring_map(fio_ring_t *ring, struct io_uring_params *p)
+{
+	ring->sq_len = p->sq_off.array + p->sq_entries * sizeof(unsigned int);
+	ring->cq_len = p->cq_off.cqes +
+		p->cq_entries * sizeof(struct io_uring_cqe);
+	if (p->features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cq_len > ring->sq_len)
+			ring->sq_len = ring->cq_len;
+		ring->cq_len = 0;
+	}
+	ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, ring->fd,
+			    IORING_OFF_SQ_RING);
+	if (ring->sq_ptr == MAP_FAILED)
+		return (ring->sq_ptr = NULL, -1);
+	ring->cq_ptr = ring->sq_ptr;
+	if (ring->cq_len > 0)
+		ring->cq_ptr = mmap(NULL, ring->cq_len, PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_POPULATE, ring->fd,
+				    IORING_OFF_CQ_RING);
+	if (ring->cq_ptr == MAP_FAILED)
+		return (ring->cq_ptr = NULL, -1);
+	ring->sq_entries = p->sq_entries;
+	ring->sqes = mmap(NULL, p->sq_entries * sizeof(struct io_uring_sqe),
+			  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			  ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+		return (ring->sqes = NULL, -1);
+
+	return (1);
+}
+
+/**
+ * fio_ring_open - Sets up an io_uring without liburing.
+ *
+ * Description: Only io_uring_setup, io_uring_enter and mmap are used,
+ * so <linux/io_uring.h> is all the build needs. Kernels older than 5.6
+ * lack IORING_OP_OPENAT, IORING_OP_CLOSE, IORING_OP_READ and
+ * IORING_OP_WRITE; they are recognized by IORING_FEAT_RW_CUR_POS, which
+ * came with them, and refused.
+ * Return: The ring, or NULL if io_uring is missing, disabled or too old.
+ */
+fio_ring_t *fio_ring_open(void)
+{
+	struct io_uring_params p;
+	fio_ring_t *ring;
+	char *sq, *cq;
+
+	ring = calloc(1, sizeof(fio_ring_t));
+	if (ring == NULL)
+		return (NULL);
+	memset(&p, 0, sizeof(p));
+	ring->wake = eventfd(0, EFD_CLOEXEC);
+	ring->fd = syscall(__NR_io_uring_setup, FIO_RING, &p);
+	if (ring->wake == -1 || ring->fd == -1 ||
+	    !(p.features & IORING_FEAT_RW_CUR_POS) ||
+	    fio_ring_map(ring, &p) == -1)
+	{
+		fio_ring_close(ring);
+		return (NULL);
+	}
+	sq = ring->sq_ptr;
+	cq = ring->cq_ptr;
+	ring->sq_tail = (unsigned int *)(sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned int *)(sq + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned int *)(sq + p.sq_off.array);
+	ring->cq_head = (unsigned int *)(cq + p.cq_off.head);
+	ring->cq_tail = (unsigned int *)(cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned int *)(cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+	return (ring);
+}
+
+/**
+ * fio_ring_close - Tears down an io_uring, cancelling what is in flight.
+ * @ring: The ring, possibly partly set up.
+ */
+void fio_ring_close(fio_ring_t *ring)
+{
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sq_entries *
+		       sizeof(struct io_uring_sqe));
+	if (ring->cq_ptr != NULL && ring->cq_len > 0)
+		munmap(ring->cq_ptr, ring->cq_len);
+	if (ring->sq_ptr != NULL)
+		munmap(ring->sq_ptr, ring->sq_len);
+	if (ring->fd != -1)
+		close(ring->fd);
+	if (ring->wake != -1)
+		close(ring->wake);
+	free(ring);
+}
+
+/**
+ * fio_ring_sqe - Queues a submission queue entry.
+ * @ring: The ring.
+ * @op: The IORING_OP_ opcode.
+ * @fd: The file descriptor the operation works on.
+ * @user: Pointer handed back in the completion.
+ *
+ * Description: The entry is published right away; without SQPOLL the
+ * kernel only reads it in the next io_uring_enter, so the caller may
+ * still fill in the operation's arguments. The caller keeps the number
+ * of entries in flight below the size of the ring.
+ * Return: The zeroed entry with @op, @fd and @user set.
+ */
+struct io_uring_sqe *fio_ring_sqe(fio_ring_t *ring, int op, int fd,
+				  void *user)
+{
+	struct io_uring_sqe *sqe;
+	unsigned int tail, i;
+
+	tail = *ring->sq_tail;
+	i = tail & *ring->sq_mask;
+	sqe = &ring->sqes[i];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = op;
+	sqe->fd = fd;
+	sqe->user_data = (unsigned long)user;
+	ring->sq_array[i] = i;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->queued++;
+
+	return (sqe);
+}
+
+/**
+ * fio_ring_enter - Submits the queued entries and waits for completions.
+ * @ring: The ring.
+ * @wait: The number of completions to wait for, 0 not to wait.
+ *
+ * Description: Every entry queued since the last call goes to the
+ * kernel in this single system call. Entries the kernel could not take
+ * yet stay queued for the next call.
+ * Return: 1 on success; 0 on EBUSY, when the completion ring is full
+ *         and has to be reaped first; -1 on any other error, with errno
+ *         set, after which the ring cannot be used.
+ */
+int fio_ring_enter(fio_ring_t *ring, unsigned int wait)
+{
+	long r;
+
+	do {
+		r = syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait,
+			    wait > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	} while (r == -1 && errno == EINTR);
+	if (r == -1)
+		return (errno == EBUSY ? 0 : -1);
+	ring->queued -= r;
+
+	return (1);
+}
@@ -0,0 +1,155 @@
+#include "106-fio.h"
+#include <errno.h>
+
+/**
+ * fio_uring_step - Queues the entry for the current step of a request.
+ * @ring: The ring.
+ * @req: The request, or NULL for the read of the ring's wake eventfd.
+ */
+void fio_uring_step(fio_ring_t *ring, fio_req_t *req)
+{
+	struct io_uring_sqe *sqe;
+	size_t left;
+
+	if (req == NULL)
+	{
+		sqe = fio_ring_sqe(ring, IORING_OP_READ, ring->wake, NULL);
+		sqe->addr = (unsigned long)&ring->count;
+		sqe->len = sizeof(ring->count);
+	}
+	else if (req->stage == FIO_OPEN)
+	{
+		sqe = fio_ring_sqe(ring, IORING_OP_OPENAT, AT_FDCWD, req);
+		sqe->addr = (unsigned long)req->path;
+		sqe->open_flags = req->op == FIO_READ ? O_RDONLY :
+			req->op == FIO_CREATE ? O_CREAT | O_WRONLY | O_TRUNC :
+			O_WRONLY | O_APPEND;
+		sqe->len = 0600;
+	}
+	else if (req->stage == FIO_CLOSE)
+		fio_ring_sqe(ring, IORING_OP_CLOSE, req->fd, req);
+	else if (req->op == FIO_READ)
+	{
+		left = req->cap - req->size;
+		sqe = fio_ring_sqe(ring, IORING_OP_READ, req->fd, req);
+		sqe->addr = (unsigned long)(req->data + req->size);
+		sqe->len = left < FIO_CHUNK ? left : FIO_CHUNK;
+		/* -1: the file position, so pipes and FIFOs can be read too */
+		sqe->off = (__u64)-1;
+	}
+	else
+	{
+		left = req->len - req->off;
+		sqe = fio_ring_sqe(ring, IORING_OP_WRITE, req->fd, req);
+		sqe->addr = (unsigned long)((const char *)req->buf + req->off);
+		sqe->len = left < FIO_CHUNK ? left : FIO_CHUNK;
+		/* -1: the file position, which O_APPEND keeps at the end */
+		sqe->off = req->op == FIO_APPEND ? (__u64)-1 : req->off;
+	}
+}
+
+/**
+ * fio_uring_io - Advances a request after a read or write completed.
+ * @req: The request, in the FIO_IO step.
+ * @res: The number of bytes transferred.
+ */
+static void fio_uring_io(fio_req_t *req, int res)
+{
+	if (req->op == FIO_READ && res == 0)
+	{
+		req->data[req->size] = '\0';
+		req->result = 1, req->stage = FIO_CLOSE;
+	}
+	else if (req->op == FIO_READ)
+	{
+		req->size += res;
+		if (fio_read_room(req) == -1)
+			req->error = ENOMEM, req->stage = FIO_CLOSE;
+	}
+	else if (res == 0)
+		req->error = EIO, req->stage = FIO_CLOSE;
+	else
+	{
+		req->off += res;
+		if (req->off == req->len)
+			req->result = 1, req->stage = FIO_CLOSE;
+	}
+}
+
+/**
+ * fio_uring_next - Advances a request after one of its entries completed.
+ * @req: The request.
+ * @res: The result of the entry, a negated errno on failure.
+ *
+ * Description: A request opens its file, reads or writes it until done
+ * or an error, then closes it; a failing close fails a request that
+ * wrote. Interrupted reads and writes are issued again.
+ * Return: 1 once the request is complete, 0 if it has a next step.
+ */
+int fio_uring_next(fio_req_t *req, int res)
+{
+	if (req->stage == FIO_CLOSE)
+	{
+		if (res < 0 && req->result == 1 && req->op != FIO_READ)
+			req->result = -1, req->error = -res;
+		return (1);
+	}
+	if (req->stage == FIO_OPEN && res < 0)
+		return (req->error = -res, 1);
+	if (req->stage == FIO_OPEN)
+	{
+		req->fd = res;
+		req->stage = FIO_IO;
+		if (req->op == FIO_READ && fio_read_alloc(req, req->fd) == -1)
+			req->error = ENOMEM, req->stage = FIO_CLOSE;
+		else if (req->op != FIO_READ && req->len == 0)
+			req->result = 1, req->stage = FIO_CLOSE;
+	}
+	else if (res == -EINTR || res == -EAGAIN)
+		return (0);
+	else if (res < 0)
+		req->error = -res, req->stage = FIO_CLOSE;
+	else
+		fio_uring_io(req, res);
+
+	return (0);
+}
+
+/**
+ * fio_uring_fail - Fails every request running on a ring that broke.
+ * @ctx: The context, unlocked, whose ring thread is the caller.
+ * @error: The errno io_uring_enter failed with.
+ *
+ * Description: The kernel may still complete entries it already took.
+ * A file being read or written is closed, the kernel holding its own
+ * reference for the entry in flight, but a read buffer it may still
+ * fill is left allocated rather than freed. A file whose close was
+ * submitted is left to the kernel; a read that only had its close left
+ * keeps its success.
+ */
+void fio_uring_fail(fio_ctx_t *ctx, int error)
+{
+	fio_ring_t *ring = ctx->ring;
+	fio_req_t *req, *next;
+
+	for (req = ring->running; req != NULL; req = next)
+	{
+		next = req->next;
+		req->next = NULL;
+		if (req->stage == FIO_CLOSE && req->op == FIO_READ &&
+		    req->result == 1)
+		{
+			fio_done(ctx, req);
+			continue;
+		}
+		if (req->stage == FIO_IO)
+			close(req->fd);
+		if (req->stage == FIO_IO && req->op == FIO_READ)
+			req->data = NULL, req->size = 0;
+		req->result = -1;
+		req->error = error;
+		fio_done(ctx, req);
+	}
+	ring->running = NULL;
+	ring->active = 0;
+}
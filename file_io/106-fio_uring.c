@@ -0,0 +1,156 @@
+#include "106-fio.h"
+#include <errno.h>
+
+/**
+ * fio_uring_track - Adds a request to, or removes it from, the running list.
+ * @ring: The ring.
+ * @req: The request.
+ * @add: 1 to add it, 0 to remove it.
+ */
+static void fio_uring_track(fio_ring_t *ring, fio_req_t *req, int add)
+{
+	if (add)
+	{
+		req->prev = NULL;
+		req->next = ring->running;
+		if (ring->running != NULL)
+			ring->running->prev = req;
+		ring->running = req;
+		ring->active++;
+		return;
+	}
+	if (req->prev != NULL)
+		req->prev->next = req->next;
+	else
+		ring->running = req->next;
+	if (req->next != NULL)
+		req->next->prev = req->prev;
+	req->next = NULL;
+	ring->active--;
+}
+
+/**
+ * fio_uring_reap - Handles the completions posted by the kernel.
+ * @ctx: The context.
+ *
+ * Description: A finished request is handed to fio_done and not touched
+ * afterwards, its callback may free it.
+ */
+static void fio_uring_reap(fio_ctx_t *ctx)
+{
+	fio_ring_t *ring = ctx->ring;
+	struct io_uring_cqe *cqe;
+	fio_req_t *req;
+	unsigned int head;
+	int res;
+
+	head = *ring->cq_head;
+	while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+	{
+		cqe = &ring->cqes[head & *ring->cq_mask];
+		req = (fio_req_t *)(unsigned long)cqe->user_data;
+		res = cqe->res;
+		__atomic_store_n(ring->cq_head, ++head, __ATOMIC_RELEASE);
+		if (req == NULL)
+			fio_uring_step(ring, NULL);
+		else if (fio_uring_next(req, res))
+		{
+			fio_uring_track(ring, req, 0);
+			fio_done(ctx, req);
+		}
+		else
+			fio_uring_step(ring, req);
+	}
+}
+
+/**
+ * fio_uring_thread - Drives the io_uring until the context stops.
+ * @arg: The context.
+ *
+ * Description: Each pass starts as many queued requests as the ring has
+ * room for, then submits every new entry and waits for completions in
+ * one io_uring_enter. Completions queue each request's next step for
+ * the following pass. fio_submit wakes the thread through the eventfd
+ * read that is always in flight. If io_uring_enter fails for good, the
+ * running requests fail and the queued ones go to the pool.
+ * Return: NULL.
+ */
+static void *fio_uring_thread(void *arg)
+{
+	fio_ctx_t *ctx = arg;
+	fio_ring_t *ring = ctx->ring;
+	fio_req_t *req;
+	int r = 1;
+
+	fio_uring_step(ring, NULL);
+	pthread_mutex_lock(&ctx->lock);
+	while (r != -1 && (!ctx->stop || ctx->rq_head || ring->active))
+	{
+		while (ctx->rq_head != NULL &&
+		       ring->active + 1 < ring->sq_entries)
+		{
+			req = ctx->rq_head;
+			ctx->rq_head = req->next;
+			fio_uring_track(ring, req, 1);
+			fio_uring_step(ring, req);
+		}
+		if (ctx->rq_head == NULL)
+			ctx->rq_tail = NULL;
+		pthread_mutex_unlock(&ctx->lock);
+		r = fio_ring_enter(ring, 1);
+		if (r == -1)
+			fio_uring_fail(ctx, errno);
+		else
+			fio_uring_reap(ctx);
+		pthread_mutex_lock(&ctx->lock);
+	}
+	ring->done = 1;
+	while ((req = ctx->rq_head) != NULL)
+	{
+		ctx->rq_head = req->next;
+		req->next = NULL;
+		fio_enqueue(ctx, req);
+	}
+	ctx->rq_tail = NULL;
+	pthread_cond_broadcast(&ctx->work);
+	pthread_mutex_unlock(&ctx->lock);
+
+	return (NULL);
+}
+
+/**
+ * fio_uring_start - Sets up the io_uring backend of a context.
+ * @ctx: The context.
+ *
+ * Return: 1 on success, -1 if the requests have to go to the pool.
+ */
+int fio_uring_start(fio_ctx_t *ctx)
+{
+	ctx->ring = fio_ring_open();
+	if (ctx->ring == NULL)
+		return (-1);
+	if (pthread_create(&ctx->ring->thread, NULL, fio_uring_thread,
+			   ctx) != 0)
+	{
+		fio_ring_close(ctx->ring);
+		ctx->ring = NULL;
+		return (-1);
+	}
+
+	return (1);
+}
+
+/**
+ * fio_uring_wake - Wakes the ring thread up.
+ * @ring: The ring.
+ *
+ * Description: The eventfd read the thread keeps in flight completes,
+ * which ends its io_uring_enter wait.
+ * Return: 1 on success, -1 otherwise.
+ */
+int fio_uring_wake(fio_ring_t *ring)
+{
+	uint64_t one = 1;
+
+	return (write(ring->wake, &one, sizeof(one)) == sizeof(one) ? 1 : -1);
+}
@@ -0,0 +1,179 @@
+#include "107-line_index.h"
+#include <errno.h>
+#include <string.h>
+
+/**
+ * line_index_push - Records the start of a line.
+ * @ix: The index.
+ * @off: The offset the line starts at.
+ *
+ * Return: 1 on success, 0 if memory runs out.
+ */
+int line_index_push(line_index_t *ix, off_t off)
+{
+	off_t *tmp;
+
+	if (ix->nlines + 1 >= ix->cap)
+	{
+		tmp = realloc(ix->offsets, sizeof(off_t) * (ix->cap * 2 + 64));
+		if (tmp == NULL)
+			return (0);
+		ix->offsets = tmp;
+		ix->cap = ix->cap * 2 + 64;
+	}
+	ix->offsets[++ix->nlines] = off;
+
+	return (1);
+}
+
+/**
+ * line_index_scan - Indexes a file by reading it once.
+ * @ix: The index, with fd and st set, its lines recorded up to where
+ *      the scan starts.
+ *
+ * Description: Newlines are located with memchr, which the C library
+ * implements with vector instructions, a chunk of LIDX_CHUNK at a time,
+ * from the end of the last recorded line.
+ * Return: 1 on success, 0 on failure.
+ */
+static int line_index_scan(line_index_t *ix)
+{
+	char *buf, *p, *nl;
+	off_t base = ix->offsets[ix->nlines];
+	ssize_t r = 1;
+
+	buf = malloc(LIDX_CHUNK);
+	if (buf == NULL)
+		return (0);
+	while (r != 0)
+	{
+		r = pread(ix->fd, buf, LIDX_CHUNK, base);
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r == -1)
+			break;
+		for (p = buf; (nl = memchr(p, '\n', buf + r - p)) != NULL;
+		     p = nl + 1)
+			if (!line_index_push(ix, base + (nl - buf) + 1))
+				r = -1;
+		if (r == -1)
+			break;
+		base += r;
+	}
+	free(buf);
+	if (r == 0 && base > ix->offsets[ix->nlines] &&
+	    !line_index_push(ix, base))
+		r = -1;
+	ix->st.st_size = base;
+
+	return (r == 0);
+}
+
+/**
+ * line_index_open - Opens a text file for reading lines by number.
+ * @filename: The name of the file.
+ *
+ * Description: The index is loaded from filename.lidx when it matches
+ * the file's device, inode, size and modification time. When the file
+ * only grew since, the saved lines are kept and only the data past them
+ * is scanned; otherwise the whole file is. A scanned index is saved
+ * there for next time, if the directory is writable.
+ * Return: The index, or NULL on failure.
+ */
+line_index_t *line_index_open(const char *filename)
+{
+	line_index_t *ix;
+
+	if (filename == NULL)
+		return (NULL);
+	ix = calloc(1, sizeof(line_index_t));
+	if (ix == NULL)
+		return (NULL);
+	ix->fd = open(filename, O_RDONLY);
+	ix->offsets = malloc(sizeof(off_t) * 64);
+	ix->cap = 64;
+	if (ix->fd == -1 || ix->offsets == NULL || fstat(ix->fd, &ix->st) == -1)
+	{
+		line_index_close(ix);
+		return (NULL);
+	}
+	ix->offsets[0] = 0;
+	if (line_index_load(ix, filename) == 1)
+		return (ix);
+	if (!line_index_scan(ix))
+	{
+		line_index_close(ix);
+		return (NULL);
+	}
+	line_index_save(ix, filename);
+
+	return (ix);
+}
+
+/**
+ * line_index_get - Reads a range of lines with a single pread.
+ * @ix: The index.
+ * @first: The first line, counting from 1.
+ * @last: The last line, included; clamped to the number of lines.
+ * @len: Set to the number of bytes read.
+ *
+ * Return: The lines, NUL terminated, to be freed by the caller;
+ *         NULL if the range is empty or on failure.
+ */
+char *line_index_get(const line_index_t *ix, size_t first, size_t last,
+		     size_t *len)
+{
+	size_t done = 0;
+	ssize_t r;
+	char *buf;
+
+	if (ix == NULL || len == NULL || first == 0 || first > ix->nlines)
+		return (NULL);
+	if (last > ix->nlines)
+		last = ix->nlines;
+	if (last < first)
+		return (NULL);
+	*len = ix->offsets[last] - ix->offsets[first - 1];
+	buf = malloc(*len + 1);
+	while (buf != NULL && done < *len)
+	{
+		r = pread(ix->fd, buf + done, *len - done,
+			  ix->offsets[first - 1] + done);
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r <= 0)
+		{
+			free(buf);
+			return (NULL);
+		}
+		done += r;
+	}
+	if (buf != NULL)
+		buf[*len] = '\0';
+
+	return (buf);
+}
+
+/**
+ * line_index_print - Prints a range of lines to the POSIX standard output.
+ * @ix: The index.
+ * @first: The first line, counting from 1.
+ * @last: The last line, included.
+ *
+ * Return: The number of bytes printed, 0 if no line could be read,
+ *         -1 if writing failed.
+ */
+ssize_t line_index_print(const line_index_t *ix, size_t first, size_t last)
+{
+	size_t len;
+	ssize_t w;
+	char *buf;
+
+	buf = line_index_get(ix, first, last, &len);
+	if (buf == NULL)
+		return (0);
+	w = write_all(STDOUT_FILENO, buf, len);
+	free(buf);
+
+	return (w);
+}
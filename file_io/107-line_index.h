@@ -0,0 +1,43 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include "main.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Bytes read per call while scanning a file for newlines */
+#define LIDX_CHUNK (1 << 20)
+/* Magic number opening a .lidx file, the digit is the format version */
+#define LIDX_MAGIC "LID2"
+
+/**
+ * struct line_index_s - Offsets of the lines of a text file
+ * @fd: the file, open for reading
+ * @st: status of the file when indexed, checked against the .lidx file
+ * @nlines: number of lines; a last line without '\n' counts
+ * @cap: number of entries allocated in @offsets
+ * @offsets: start of each line, followed by the size of the file, so
+ *           line n (1-based) spans offsets[n - 1] to offsets[n]
+ */
+typedef struct line_index_s
+{
+	int fd;
+	struct stat st;
+	size_t nlines;
+	size_t cap;
+	off_t *offsets;
+} line_index_t;
+
+/* 107-line_index.c */
+int line_index_push(line_index_t *ix, off_t off);
+line_index_t *line_index_open(const char *filename);
+char *line_index_get(const line_index_t *ix, size_t first, size_t last,
+		     size_t *len);
+ssize_t line_index_print(const line_index_t *ix, size_t first, size_t last);
+
+/* 107-line_index_file.c */
+int line_index_save(const line_index_t *ix, const char *filename);
+int line_index_load(line_index_t *ix, const char *filename);
+void line_index_close(line_index_t *ix);
+
+#endif
@@ -0,0 +1,220 @@
+#include "107-line_index.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * lidx_put - Encodes a number in 7-bit groups, low bits first.
+ * @p: Where to write, advanced past the encoding (1 to 10 bytes).
+ * @v: The number.
+ */
+static void lidx_put(unsigned char **p, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		*(*p)++ = (v & 0x7f) | 0x80;
+		v >>= 7;
+	}
+	*(*p)++ = v;
+}
+
+/**
+ * lidx_get - Decodes a number written by lidx_put.
+ * @p: Where to read, advanced past the encoding.
+ * @end: End of the buffer.
+ * @v: Set to the number.
+ *
+ * Return: 1 on success, 0 if the encoding is truncated or too long.
+ */
+static int lidx_get(const unsigned char **p, const unsigned char *end,
+		    uint64_t *v)
+{
+	int shift;
+
+	*v = 0;
+	for (shift = 0; *p < end && shift < 64; shift += 7)
+	{
+		*v |= (uint64_t)(**p & 0x7f) << shift;
+		if (!(*(*p)++ & 0x80))
+			return (1);
+	}
+
+	return (0);
+}
+
+/**
+ * lidx_encode - Encodes an index for saving.
+ * @ix: The index.
+ * @len: Set to the size of the encoding.
+ *
+ * Description: LIDX_MAGIC, then the device, inode, size and modification
+ * time of the indexed file and the number of lines, then the length of each
+ * line, all as variable-length numbers: lines under 128 bytes cost one
+ * byte each.
+ * Return: The encoding, to be freed by the caller; NULL on failure.
+ */
+static unsigned char *lidx_encode(const line_index_t *ix, size_t *len)
+{
+	unsigned char *buf, *p;
+	size_t k;
+
+	buf = malloc(sizeof(LIDX_MAGIC) + 10 * (ix->nlines + 6));
+	if (buf == NULL)
+		return (NULL);
+	memcpy(buf, LIDX_MAGIC, sizeof(LIDX_MAGIC) - 1);
+	p = buf + sizeof(LIDX_MAGIC) - 1;
+	lidx_put(&p, ix->st.st_dev);
+	lidx_put(&p, ix->st.st_ino);
+	lidx_put(&p, ix->st.st_size);
+	lidx_put(&p, ix->st.st_mtim.tv_sec);
+	lidx_put(&p, ix->st.st_mtim.tv_nsec);
+	lidx_put(&p, ix->nlines);
+	for (k = 1; k <= ix->nlines; k++)
+		lidx_put(&p, ix->offsets[k] - ix->offsets[k - 1]);
+	*len = p - buf;
+
+	return (buf);
+}
+
+/**
+ * line_index_save - Saves an index to filename.lidx.
+ * @ix: The index.
+ * @filename: The name of the indexed file.
+ *
+ * Description: The index is written under a unique temporary name made
+ * by mkstemp and renamed, so readers never load half an index and
+ * threads or processes saving the same index do not write over each
+ * other's temporary file.
+ * Return: 1 on success, 0 on failure.
+ */
+int line_index_save(const line_index_t *ix, const char *filename)
+{
+	unsigned char *buf;
+	char *path, *tmp;
+	size_t len;
+	int fd = -1, ok = 0;
+
+	buf = lidx_encode(ix, &len);
+	path = malloc(strlen(filename) + sizeof(".lidx"));
+	tmp = malloc(strlen(filename) + sizeof(".lidx.XXXXXX"));
+	if (buf != NULL && path != NULL && tmp != NULL)
+	{
+		sprintf(path, "%s.lidx", filename);
+		sprintf(tmp, "%s.lidx.XXXXXX", filename);
+		fd = mkstemp(tmp);
+	}
+	if (fd != -1)
+	{
+		ok = fchmod(fd, 0644) == 0 && write_all(fd, buf, len) != -1;
+		if (close(fd) == -1)
+			ok = 0;
+		if (ok && rename(tmp, path) == -1)
+			ok = 0;
+		if (!ok)
+			unlink(tmp);
+	}
+	free(tmp);
+	free(path);
+	free(buf);
+
+	return (ok);
+}
+
+/**
+ * lidx_decode - Checks and decodes a saved index.
+ * @ix: The index, with fd and st set and no line recorded.
+ * @p: The start of the saved index.
+ * @end: The end of the saved index.
+ *
+ * Description: A saved index of the same device and inode but a smaller
+ * size is taken as the index of a file that was appended to, as logs
+ * are: its lines are kept but the last one, which the caller scans
+ * again from its start along with the new data. The byte before that
+ * start must still be a newline.
+ * Return: 1 if the saved index describes the file as it is now, 2 if
+ *         it describes the start of the file, 0 if it is stale or
+ *         corrupt (no line is then recorded).
+ */
+static int lidx_decode(line_index_t *ix, const unsigned char *p,
+		       const unsigned char *end)
+{
+	uint64_t v[6], len, size = ix->st.st_size;
+	int i, ok = 1;
+	char c = '\n';
+
+	if (end - p < 4 || memcmp(p, LIDX_MAGIC, sizeof(LIDX_MAGIC) - 1) != 0)
+		return (0);
+	p += sizeof(LIDX_MAGIC) - 1;
+	for (i = 0; i < 6 && ok; i++)
+		ok = lidx_get(&p, end, &v[i]);
+	ok = ok && v[0] == (uint64_t)ix->st.st_dev &&
+		v[1] == (uint64_t)ix->st.st_ino && v[5] <= v[2] &&
+		(v[2] < size || (v[2] == size &&
+		v[3] == (uint64_t)ix->st.st_mtim.tv_sec &&
+		v[4] == (uint64_t)ix->st.st_mtim.tv_nsec));
+	while (ok && ix->nlines < v[5])
+		ok = lidx_get(&p, end, &len) && len > 0 &&
+			len <= v[2] - ix->offsets[ix->nlines] &&
+			line_index_push(ix, ix->offsets[ix->nlines] + len);
+	ok = ok && p == end && ix->offsets[ix->nlines] == (off_t)v[2];
+	if (ok && v[2] < size)
+	{
+		ix->nlines -= ix->nlines > 0;
+		if (ix->offsets[ix->nlines] > 0)
+			ok = pread(ix->fd, &c, 1,
+				   ix->offsets[ix->nlines] - 1) == 1;
+		ok = ok && c == '\n' ? 2 : 0;
+	}
+	if (!ok)
+		ix->nlines = 0;
+
+	return (ok);
+}
+
+/**
+ * line_index_load - Loads the index saved for a file, if still valid.
+ * @ix: The index, with fd and st set and no line recorded.
+ * @filename: The name of the indexed file.
+ *
+ * Return: 1 if the index was loaded, 2 if only the lines before the
+ *         last saved one were, the file having grown since; 0 if it is
+ *         missing, stale or bad.
+ */
+int line_index_load(line_index_t *ix, const char *filename)
+{
+	unsigned char *buf = NULL;
+	struct stat st;
+	char *path;
+	int fd = -1, ok = 0;
+
+	path = malloc(strlen(filename) + sizeof(".lidx"));
+	if (path != NULL)
+	{
+		sprintf(path, "%s.lidx", filename);
+		fd = open(path, O_RDONLY);
+		free(path);
+	}
+	if (fd == -1)
+		return (0);
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		buf = malloc(st.st_size);
+	if (buf != NULL && read(fd, buf, st.st_size) == st.st_size)
+		ok = lidx_decode(ix, buf, buf + st.st_size);
+	close(fd);
+	free(buf);
+
+	return (ok);
+}
+
+/**
+ * line_index_close - Closes a file opened with line_index_open.
+ * @ix: The index.
+ */
+void line_index_close(line_index_t *ix)
+{
+	if (ix == NULL)
+		return;
+	if (ix->fd != -1)
+		close(ix->fd);
+	free(ix->offsets);
+	free(ix);
+}
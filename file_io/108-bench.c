@@ -0,0 +1,114 @@
+#include "108-bench.h"
+#include <string.h>
+
+/**
+ * bench_parse_size - parses a size such as 4096, 64K, 256M or 4G
+ * @s: the string
+ *
+ * Return: the size in bytes, 0 if @s is not a size
+ */
+static size_t bench_parse_size(const char *s)
+{
+	char *end;
+	size_t n;
+
+	n = strtoul(s, &end, 10);
+	if (end == s)
+		return (0);
+	if (*end == 'K' || *end == 'k')
+		n <<= 10, end++;
+	else if (*end == 'M' || *end == 'm')
+		n <<= 20, end++;
+	else if (*end == 'G' || *end == 'g')
+		n <<= 30, end++;
+
+	return (*end == '\0' ? n : 0);
+}
+
+/**
+ * bench_dir - runs every operation on every size in one directory
+ * @b: configuration, dir, cp and repeat set
+ * @max: largest size
+ */
+static void bench_dir(bench_t *b, size_t max)
+{
+	int i;
+
+	for (b->size = BENCH_MIN_SIZE; b->size <= max; b->size *= 16)
+	{
+		sprintf(b->src, "%.4000s/bench_src.%ld", b->dir, (long)getpid());
+		sprintf(b->dst, "%.4000s/bench_dst.%ld", b->dir, (long)getpid());
+		if (!bench_make_file(b->src, b->size))
+		{
+			dprintf(STDERR_FILENO, "Error: Can't write to %s\n", b->src);
+			unlink(b->src);
+			return;
+		}
+		b->text = bench_make_text(b->size);
+		for (i = 0; bench_ops[i].name != NULL; i++)
+			bench_run(&bench_ops[i], b);
+		read_textfile_mmap_clear();
+		free(b->text);
+		unlink(b->src);
+		unlink(b->dst);
+		if (b->size > max / 16)
+			break;
+	}
+}
+
+/**
+ * main - benchmarks the file_io primitives and the cp tool
+ * @argc: number of arguments
+ * @argv: array of arguments
+ *
+ * Description: bench [-d dir]... [-m max_size] [-r repeat] [-c cp]
+ * [-s trace_size]; files from 1K to max_size (64M by default) are created
+ * in each dir (/dev/shm and . by default, that is tmpfs and disk) and
+ * every primitive, and every cp copy strategy when the cp binary is
+ * found, is timed with a warm page cache. Every system call is counted
+ * by one more traced run, for sizes up to trace_size only (1K by
+ * default, 0 for none) as it costs as much as the timed runs.
+ *
+ * Return: 0 on success, 1 on a usage error
+ */
+int main(int argc, char *argv[])
+{
+	const char *dirs[BENCH_MAX_DIRS] = {"/dev/shm", "."};
+	int i, ndirs = 0;
+	size_t max = BENCH_MAX_SIZE;
+	bench_t b;
+
+	b.cp = access("./cp", X_OK) == 0 ? "./cp" : NULL;
+	b.repeat = 3;
+	b.trace = BENCH_MIN_SIZE;
+	for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2)
+	{
+		if (strcmp(argv[i], "-d") == 0 && ndirs < BENCH_MAX_DIRS)
+			dirs[ndirs++] = argv[i + 1];
+		else if (strcmp(argv[i], "-m") == 0)
+			max = bench_parse_size(argv[i + 1]);
+		else if (strcmp(argv[i], "-r") == 0)
+			b.repeat = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-c") == 0)
+			b.cp = argv[i + 1];
+		else if (strcmp(argv[i], "-s") == 0)
+			b.trace = bench_parse_size(argv[i + 1]);
+		else
+			break;
+	}
+	if (i != argc || max < BENCH_MIN_SIZE || b.repeat < 1)
+	{
+		dprintf(STDERR_FILENO, "Usage: bench [-d dir]... [-m max_size]"
+			" [-r repeat] [-c cp] [-s trace_size]\n");
+		return (1);
+	}
+	printf("%-12s %6s  %-24s %14s %13s %18s %14s\n", "dir", "size",
+	       "operation", "throughput", "read/write", "all syscalls", "CPU");
+	for (i = 0; i < (ndirs ? ndirs : 2); i++)
+	{
+		b.dir = dirs[i];
+		bench_dir(&b, max);
+	}
+
+	return (0);
+}
@@ -0,0 +1,95 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "main.h"
+#include <sys/types.h>
+
+/* Smallest file size benchmarked; each step is 16 times larger */
+#define BENCH_MIN_SIZE 1024UL
+/* Largest size by default; -m raises it to the multi-GB range */
+#define BENCH_MAX_SIZE (64UL << 20)
+/* Largest text kept in memory for the create and append primitives */
+#define BENCH_TEXT_MAX (1UL << 30)
+#define BENCH_MAX_DIRS 8
+#define BENCH_PATH_MAX 4096
+/* Bounds of the command line of a cp run */
+#define BENCH_ARGS_MAX 64
+#define BENCH_ARGV_MAX 16
+
+/**
+ * struct bench_s - One benchmark configuration
+ * @dir: directory the files live in
+ * @src: file read by the primitives and copied by cp
+ * @dst: file written by the primitives and by cp
+ * @size: size of @src in bytes
+ * @text: @size bytes of text plus a NUL, NULL if too large to hold
+ * @cp: path of the cp binary, NULL to skip the cp runs
+ * @repeat: runs per measurement, the fastest one is reported
+ * @trace: largest size whose system calls are counted under ptrace,
+ * 0 to count none
+ */
+typedef struct bench_s
+{
+	const char *dir;
+	char src[BENCH_PATH_MAX];
+	char dst[BENCH_PATH_MAX];
+	size_t size;
+	char *text;
+	const char *cp;
+	int repeat;
+	size_t trace;
+} bench_t;
+
+/**
+ * struct bench_stat_s - Cost of one run
+ * @wall: elapsed time in seconds
+ * @cpu: user plus system time in seconds
+ * @rw: read and write family system calls, from /proc/<pid>/io
+ * @ok: nonzero if the run succeeded
+ */
+typedef struct bench_stat_s
+{
+	double wall;
+	double cpu;
+	unsigned long rw;
+	int ok;
+} bench_stat_t;
+
+/**
+ * struct bench_op_s - One thing to measure
+ * @name: label printed in the report
+ * @run: in-process primitive, returns nonzero on success; NULL for cp
+ * @cp_args: options given to the cp binary, when @run is NULL
+ * @text: nonzero if @run needs bench_t.text
+ */
+typedef struct bench_op_s
+{
+	const char *name;
+	int (*run)(const bench_t *b);
+	const char *cp_args;
+	int text;
+} bench_op_t;
+
+/* 108-bench_ops.c, terminated by a NULL name */
+extern const bench_op_t bench_ops[];
+
+/* 108-bench_file.c */
+int bench_make_file(const char *path, size_t size);
+char *bench_make_text(size_t size);
+
+/* 108-bench_write.c */
+int bench_create(const bench_t *b);
+int bench_create_len(const bench_t *b);
+int bench_create_atomic(const bench_t *b);
+int bench_append(const bench_t *b);
+int bench_append_len(const bench_t *b);
+
+/* 108-bench_measure.c */
+void bench_run(const bench_op_t *op, const bench_t *b);
+
+/* 108-bench_trace.c */
+void bench_cp_argv(const bench_op_t *op, const bench_t *b, char *args,
+		   char **argv);
+unsigned long bench_trace(const bench_op_t *op, const bench_t *b);
+
+#endif
@@ -0,0 +1,56 @@
+#include "108-bench.h"
+#include <string.h>
+
+/* Line the benchmark files are made of, 64 bytes long */
+#define BENCH_LINE \
+	"The quick brown fox jumps over the lazy dog; 0123456789 ABCDEF.\n"
+
+/**
+ * bench_make_text - Builds text of a given size in memory.
+ * @size: The number of bytes, not counting the NUL.
+ *
+ * Return: The text, to be freed by the caller; NULL if @size exceeds
+ *         BENCH_TEXT_MAX or memory runs out.
+ */
+char *bench_make_text(size_t size)
+{
+	size_t i, n = sizeof(BENCH_LINE) - 1;
+	char *text;
+
+	if (size > BENCH_TEXT_MAX)
+		return (NULL);
+	text = malloc(size + 1);
+	if (text == NULL)
+		return (NULL);
+	for (i = 0; i < size; i += n)
+		memcpy(text + i, BENCH_LINE, size - i < n ? size - i : n);
+	text[size] = '\0';
+
+	return (text);
+}
+
+/**
+ * bench_make_file - Creates a text file of a given size.
+ * @path: The name of the file.
+ * @size: The number of bytes.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int bench_make_file(const char *path, size_t size)
+{
+	size_t chunk = size < (1UL << 20) ? size : (1UL << 20), done, n;
+	char *text = bench_make_text(chunk);
+	int fd, ok = text != NULL;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	for (done = 0; ok && fd != -1 && done < size; done += n)
+	{
+		n = size - done < chunk ? size - done : chunk;
+		ok = write_all(fd, text, n) != -1;
+	}
+	if (fd == -1 || close(fd) == -1)
+		ok = 0;
+	free(text);
+
+	return (ok);
+}
@@ -0,0 +1,189 @@
+#include "108-bench.h"
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * bench_proc_io - Counts the read and write calls a process made so far.
+ * @pid: The process, 0 for the calling one.
+ *
+ * Description: Sums syscr and syscw from /proc/<pid>/io with a single
+ * read, which the count of the calling process includes.
+ * Return: The number of calls, 0 if /proc is not available.
+ */
+static unsigned long bench_proc_io(pid_t pid)
+{
+	char path[64], buf[512], *p;
+	unsigned long n = 0;
+	ssize_t r;
+	int fd;
+
+	if (pid == 0)
+		strcpy(path, "/proc/self/io");
+	else
+		sprintf(path, "/proc/%ld/io", (long)pid);
+	fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return (0);
+	r = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	buf[r > 0 ? r : 0] = '\0';
+	p = strstr(buf, "syscr:");
+	if (p != NULL)
+		n += strtoul(p + 6, NULL, 10);
+	p = strstr(buf, "syscw:");
+	if (p != NULL)
+		n += strtoul(p + 6, NULL, 10);
+
+	return (n);
+}
+
+/**
+ * bench_cpu - Adds up user and system time.
+ * @ru: Resource usage.
+ *
+ * Return: CPU time in seconds.
+ */
+static double bench_cpu(const struct rusage *ru)
+{
+	return (ru->ru_utime.tv_sec + ru->ru_stime.tv_sec +
+		(ru->ru_utime.tv_usec + ru->ru_stime.tv_usec) / 1e6);
+}
+
+/**
+ * bench_self - Measures a primitive run by the calling process.
+ * @op: The primitive.
+ * @b: The configuration.
+ * @st: Filled with the cost of the run.
+ *
+ * Description: Standard output goes to /dev/null meanwhile, so the read
+ * primitives pay for their writes but not for a terminal; the run fails
+ * without touching it if it cannot be redirected.
+ */
+static void bench_self(const bench_op_t *op, const bench_t *b,
+		       bench_stat_t *st)
+{
+	struct rusage r0, r1;
+	struct timespec t0, t1;
+	unsigned long io0;
+	int out, null;
+
+	fflush(stdout);
+	memset(st, 0, sizeof(*st));
+	out = dup(STDOUT_FILENO);
+	null = open("/dev/null", O_WRONLY);
+	if (out == -1 || null == -1 || dup2(null, STDOUT_FILENO) == -1)
+	{
+		if (out != -1)
+			close(out);
+		if (null != -1)
+			close(null);
+		return;
+	}
+	getrusage(RUSAGE_SELF, &r0);
+	io0 = bench_proc_io(0);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	st->ok = op->run(b);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	st->rw = bench_proc_io(0) - io0 - 1;
+	getrusage(RUSAGE_SELF, &r1);
+	dup2(out, STDOUT_FILENO);
+	close(out);
+	close(null);
+
+	st->wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	st->cpu = bench_cpu(&r1) - bench_cpu(&r0);
+}
+
+/**
+ * bench_child - Measures one run of the cp binary.
+ * @op: The cp options to use.
+ * @b: The configuration.
+ * @st: Filled with the cost of the run.
+ *
+ * Description: waitid with WNOWAIT leaves the exited child in place, so
+ * its /proc/<pid>/io can still be read before wait4 reaps it and returns
+ * its CPU time.
+ */
+static void bench_child(const bench_op_t *op, const bench_t *b,
+			bench_stat_t *st)
+{
+	char args[BENCH_ARGS_MAX], *argv[BENCH_ARGV_MAX];
+	struct timespec t0, t1;
+	struct rusage ru;
+	siginfo_t info;
+	int status = 1, null;
+	pid_t pid;
+
+	bench_cp_argv(op, b, args, argv);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	pid = fork();
+	if (pid == 0)
+	{
+		null = open("/dev/null", O_WRONLY);
+		dup2(null, STDOUT_FILENO);
+		dup2(null, STDERR_FILENO);
+		execv(b->cp, argv);
+		_exit(127);
+	}
+	st->ok = pid != -1 && waitid(P_PID, pid, &info, WEXITED | WNOWAIT) == 0;
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	st->rw = st->ok ? bench_proc_io(pid) : 0;
+	st->ok = st->ok && wait4(pid, &status, 0, &ru) == pid &&
+		 WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	st->wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	st->cpu = st->ok ? bench_cpu(&ru) : 0;
+}
+
+/**
+ * bench_run - Measures an operation and prints its fastest run.
+ * @op: The operation.
+ * @b: The configuration.
+ *
+ * Description: The timed runs count read and write calls only, which
+ * /proc/<pid>/io gives for free; for sizes up to b->trace, one more run
+ * under ptrace counts every system call, as tracing slows it down too
+ * much to time it.
+ */
+void bench_run(const bench_op_t *op, const bench_t *b)
+{
+	bench_stat_t st, best = {0, 0, 0, 0};
+	const char *unit = "KMGT";
+	size_t size = b->size >> 10;
+	int i;
+
+	if (op->run == NULL && b->cp == NULL)
+		return;
+	while (size >= 1024 && unit[1] != '\0')
+		size >>= 10, unit++;
+	printf("%-12s %5lu%c  %-24s", b->dir, (unsigned long)size, *unit,
+	       op->name);
+	if (op->text && b->text == NULL)
+	{
+		printf(" skipped, text too large to hold\n");
+		return;
+	}
+	for (i = 0; i < b->repeat; i++)
+	{
+		if (op->run != NULL)
+			bench_self(op, b, &st);
+		else
+			bench_child(op, b, &st);
+		if (st.ok && (!best.ok || st.wall < best.wall))
+			best = st;
+	}
+	if (!best.ok)
+	{
+		printf(" failed\n");
+		return;
+	}
+	printf(" %9.1f MB/s %9lu r/w", b->size /
+	       (best.wall > 0 ? best.wall : 1e-9) / 1e6, best.rw);
+	if (b->size <= b->trace)
+		printf(" %9lu syscalls", bench_trace(op, b));
+	else
+		printf(" %9s syscalls", "-");
+	printf(" %8.3f s CPU\n", best.cpu);
+}
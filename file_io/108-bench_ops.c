@@ -0,0 +1,53 @@
+#include "108-bench.h"
+
+/**
+ * op_read - Runs read_textfile on the whole source.
+ * @b: The configuration.
+ *
+ * Return: 1 if every byte was printed, 0 otherwise.
+ */
+static int op_read(const bench_t *b)
+{
+	return (read_textfile(b->src, b->size) == (ssize_t)b->size);
+}
+
+/**
+ * op_read_stream - Runs read_textfile_stream on the whole source.
+ * @b: The configuration.
+ *
+ * Return: 1 if every byte was printed, 0 otherwise.
+ */
+static int op_read_stream(const bench_t *b)
+{
+	return (read_textfile_stream(b->src, b->size) == (ssize_t)b->size);
+}
+
+/**
+ * op_read_mmap - Runs read_textfile_mmap on the whole source.
+ * @b: The configuration.
+ *
+ * Return: 1 if every byte was printed, 0 otherwise.
+ */
+static int op_read_mmap(const bench_t *b)
+{
+	return (read_textfile_mmap(b->src, b->size) == (ssize_t)b->size);
+}
+
+const bench_op_t bench_ops[] = {
+	{"read_textfile", op_read, NULL, 0},
+	{"read_textfile_stream", op_read_stream, NULL, 0},
+	{"read_textfile_mmap", op_read_mmap, NULL, 0},
+	{"create_file", bench_create, NULL, 1},
+	{"create_file_len", bench_create_len, NULL, 1},
+	{"create_file_atomic", bench_create_atomic, NULL, 1},
+	{"append_text_to_file", bench_append, NULL, 1},
+	{"append_text_to_file_len", bench_append_len, NULL, 1},
+	{"cp", NULL, "", 0},
+	{"cp -b", NULL, "-b", 0},
+	{"cp -a -b", NULL, "-a -b", 0},
+	{"cp -k", NULL, "-k", 0},
+	{"cp -a -k", NULL, "-a -k", 0},
+	{"cp -c", NULL, "-c", 0},
+	{"cp -s end", NULL, "-s end", 0},
+	{NULL, NULL, NULL, 0}
+};
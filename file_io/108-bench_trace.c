@@ -0,0 +1,97 @@
+#include "108-bench.h"
+#include <string.h>
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+
+/**
+ * bench_cp_argv - Builds the command line of a cp run.
+ * @op: The cp options to use.
+ * @b: The configuration.
+ * @args: Buffer of BENCH_ARGS_MAX bytes the options are split in.
+ * @argv: Array of BENCH_ARGV_MAX pointers, NULL terminated on return.
+ */
+void bench_cp_argv(const bench_op_t *op, const bench_t *b, char *args,
+		   char **argv)
+{
+	int argc = 0;
+
+	strncpy(args, op->cp_args, BENCH_ARGS_MAX - 1);
+	args[BENCH_ARGS_MAX - 1] = '\0';
+	argv[argc++] = (char *)b->cp;
+	for (argv[argc] = strtok(args, " ");
+	     argv[argc] != NULL && argc < BENCH_ARGV_MAX - 4;)
+		argv[++argc] = strtok(NULL, " ");
+	argv[argc++] = (char *)b->src;
+	argv[argc++] = (char *)b->dst;
+	argv[argc] = NULL;
+}
+
+/**
+ * bench_tracee - Runs an operation in a child that asked to be traced.
+ * @op: The operation.
+ * @b: The configuration.
+ */
+static void bench_tracee(const bench_op_t *op, const bench_t *b)
+{
+	char args[BENCH_ARGS_MAX], *argv[BENCH_ARGV_MAX];
+	int null;
+
+	null = open("/dev/null", O_WRONLY);
+	dup2(null, STDOUT_FILENO);
+	if (op->run == NULL)
+		dup2(null, STDERR_FILENO);
+	if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1)
+		_exit(126);
+	raise(SIGSTOP);
+	if (op->run != NULL)
+		_exit(op->run(b) ? 0 : 1);
+	bench_cp_argv(op, b, args, argv);
+	execv(b->cp, argv);
+	_exit(127);
+}
+
+/**
+ * bench_trace - Counts every system call of one run of an operation.
+ * @op: The operation.
+ * @b: The configuration.
+ *
+ * Description: The run happens in a child stopped at each system call
+ * entry and exit with PTRACE_SYSCALL, threads included, so it is kept
+ * apart from the timed runs. Each call makes two stops, except the last
+ * one of each thread, which never returns.
+ * Return: The number of system calls, 0 if ptrace is not permitted.
+ */
+unsigned long bench_trace(const bench_op_t *op, const bench_t *b)
+{
+	unsigned long stops = 0, threads = 0;
+	int status, sig;
+	pid_t pid;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid == 0)
+		bench_tracee(op, b);
+	if (pid == -1 || waitpid(pid, &status, 0) != pid || !WIFSTOPPED(status))
+		return (0);
+	ptrace(PTRACE_SETOPTIONS, pid, NULL,
+	       (void *)(long)(PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE |
+			      PTRACE_O_EXITKILL));
+	ptrace(PTRACE_SYSCALL, pid, NULL, NULL);
+	while ((pid = waitpid(-1, &status, __WALL)) > 0)
+	{
+		if (WIFEXITED(status) || WIFSIGNALED(status))
+		{
+			threads++;
+			continue;
+		}
+		sig = WSTOPSIG(status);
+		if (sig == (SIGTRAP | 0x80))
+			stops++;
+		if (sig == (SIGTRAP | 0x80) || sig == SIGTRAP || sig == SIGSTOP)
+			sig = 0;
+		ptrace(PTRACE_SYSCALL, pid, NULL, (void *)(long)sig);
+	}
+
+	return ((stops + threads) / 2);
+}
@@ -0,0 +1,61 @@
+#include "108-bench.h"
+
+/**
+ * bench_create - Runs create_file with the whole text.
+ * @b: The configuration.
+ *
+ * Return: 1 on success, 0 otherwise.
+ */
+int bench_create(const bench_t *b)
+{
+	return (create_file(b->dst, b->text) == 1);
+}
+
+/**
+ * bench_create_len - Runs create_file_len with the whole text.
+ * @b: The configuration.
+ *
+ * Return: 1 on success, 0 otherwise.
+ */
+int bench_create_len(const bench_t *b)
+{
+	return (create_file_len(b->dst, b->text, b->size) == 1);
+}
+
+/**
+ * bench_create_atomic - Runs create_file_atomic, not durable, with the
+ *                       whole text.
+ * @b: The configuration.
+ *
+ * Return: 1 on success, 0 otherwise.
+ */
+int bench_create_atomic(const bench_t *b)
+{
+	return (create_file_atomic(b->dst, b->text, 0) == 1);
+}
+
+/**
+ * bench_append - Empties the destination and runs append_text_to_file
+ *                with the whole text.
+ * @b: The configuration.
+ *
+ * Return: 1 on success, 0 otherwise.
+ */
+int bench_append(const bench_t *b)
+{
+	return (create_file(b->dst, NULL) == 1 &&
+		append_text_to_file(b->dst, b->text) == 1);
+}
+
+/**
+ * bench_append_len - Empties the destination and runs
+ *                    append_text_to_file_len with the whole text.
+ * @b: The configuration.
+ *
+ * Return: 1 on success, 0 otherwise.
+ */
+int bench_append_len(const bench_t *b)
+{
+	return (create_file(b->dst, NULL) == 1 &&
+		append_text_to_file_len(b->dst, b->text, b->size) == 1);
+}
@@ -1,4 +1,5 @@
-#include "main.h"
+#include "3-cp.h"
+#include <string.h>
 
 /**
  * close_fd - closes a file descriptor and exits on failure
@@ -42,48 +43,105 @@ void error(int code, const char *file, int fd1, int fd2, const char *msg)
 	exit(code);
 }
 
+/**
+ * cp_parse_opts - parses the options given before the file operands
+ * @argc: number of arguments
+ * @argv: array of arguments
+ * @opts: options to fill
+ *
+ * Return: index of the first operand, or -1 on an unknown option
+ */
+int cp_parse_opts(int argc, char *argv[], cp_opts_t *opts)
+{
+	int i;
+
+	opts->async = 0;
+	opts->recursive = 0;
+	opts->nocache = 0;
+	opts->sync = CP_SYNC_NONE;
+	opts->sync_bytes = 0;
+	opts->checksum = CP_SUM_NONE;
+	opts->buffered = 0;
+	for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++)
+	{
+		if (strcmp(argv[i], "--") == 0)
+			return (i + 1);
+		if (strcmp(argv[i], "-a") == 0)
+			opts->async = 1;
+		else if (strcmp(argv[i], "-r") == 0)
+			opts->recursive = 1;
+		else if (strcmp(argv[i], "-c") == 0)
+			opts->nocache = 1;
+		else if (strcmp(argv[i], "-b") == 0)
+			opts->buffered = 1;
+		else if (strcmp(argv[i], "-k") == 0)
+			opts->checksum = CP_SUM_STDERR;
+		else if (strcmp(argv[i], "-K") == 0)
+			opts->checksum = CP_SUM_SIDECAR;
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			if (cp_parse_sync(argv[++i], opts) == 0)
+				return (-1);
+		}
+		else
+			return (-1);
+	}
+
+	return (i);
+}
+
 /**
  * main - copies the content of a file to another file
  * @argc: number of arguments
  * @argv: array of arguments
  *
+ * Description: cp [-a] [-b] [-c] [-k|-K] [-r] [-s none|end|N] file_from
+ * file_to; with -r a directory file_from is copied as a whole tree.
+ *
  * Return: 0 (Success))
  */
 int main(int argc, char *argv[])
 {
-	int from, to;
-	ssize_t r, w;
-	char buf[1 << 10];
+	int from, to, i;
+	uint32_t crc;
+	struct stat st;
+	cp_status_t status;
+	cp_opts_t opts;
 
-	if (argc != 3)
+	i = cp_parse_opts(argc, argv, &opts);
+	if (i == -1 || argc - i != 2)
 	{
 		dprintf(STDERR_FILENO, "Usage: cp file_from file_to\n");
 		exit(97);
 	}
+	argv += i - 1;
+	if (opts.recursive && stat(argv[1], &st) == 0 && S_ISDIR(st.st_mode))
+		return (cp_tree(argv[1], argv[2], &opts));
 	from = open(argv[1], O_RDONLY);
-	if (from == -1)
+	if (from == -1 || fstat(from, &st) == -1)
 	{
-		error(98, argv[1], -1, -1, "Error: Can't read from file %s\n");
+		error(98, argv[1], from, -1, "Error: Can't read from file %s\n");
 	}
 	to = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0664);
 	if (to == -1)
 	{
 		error(99, argv[2], from, -1, "Error: Can't write to %s\n");
 	}
-	while ((r = read(from, buf, 1 << 10)))
+	status = cp_copy(from, to, &st, &opts, &crc);
+	if (status == CP_EWRITE)
 	{
-		w = write(to, buf, r);
-		if (w != r)
-		{
-			error(99, argv[2], from, to, "Error: Can't write to %s\n");
-		}
+		error(99, argv[2], from, to, "Error: Can't write to %s\n");
 	}
-	if (r == -1)
+	if (status == CP_EREAD)
 	{
 		error(98, argv[1], from, to, "Error: Can't read from file %s\n");
 	}
 	close_fd(from);
 	close_fd(to);
+	if (!cp_crc_report(&opts, argv[2], crc))
+	{
+		error(99, argv[2], -1, -1, "Error: Can't write to %s.crc32c\n");
+	}
 
 	return (0);
 }
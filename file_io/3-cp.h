@@ -0,0 +1,231 @@
+#ifndef CP_H
+#define CP_H
+
+#define _GNU_SOURCE /* copy_file_range, SEEK_DATA, fallocate, ... */
+
+#include "main.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/* Bytes handed to the kernel per copy_file_range/sendfile call */
+#define CP_BUF_SIZE (1 << 20)
+/* Bounds of the user buffer used when the kernel cannot copy by itself */
+#define CP_BUF_MIN (1 << 16)
+#define CP_BUF_MAX (1 << 23)
+
+/**
+ * enum cp_status_e - Outcome of a copy strategy
+ * @CP_DONE: The whole source has been copied
+ * @CP_EREAD: Reading the source failed (exit 98)
+ * @CP_EWRITE: Writing the destination failed (exit 99)
+ * @CP_UNSUPPORTED: The strategy does not apply, try the next one
+ */
+typedef enum cp_status_e
+{
+	CP_DONE,
+	CP_EREAD,
+	CP_EWRITE,
+	CP_UNSUPPORTED
+} cp_status_t;
+
+/**
+ * enum cp_sync_e - When the destination is flushed with fdatasync
+ * @CP_SYNC_NONE: never, the kernel writes it back on its own schedule
+ * @CP_SYNC_END: once, after the last byte is written
+ * @CP_SYNC_EVERY: every cp_opts_t.sync_bytes bytes, and at the end
+ */
+typedef enum cp_sync_e
+{
+	CP_SYNC_NONE,
+	CP_SYNC_END,
+	CP_SYNC_EVERY
+} cp_sync_t;
+
+/**
+ * enum cp_sum_e - Where the CRC32C of each copied file is reported
+ * @CP_SUM_NONE: no checksum is computed
+ * @CP_SUM_STDERR: -k, "crc  file_to" lines on standard error
+ * @CP_SUM_SIDECAR: -K, the same line in file_to.crc32c
+ */
+typedef enum cp_sum_e
+{
+	CP_SUM_NONE,
+	CP_SUM_STDERR,
+	CP_SUM_SIDECAR
+} cp_sum_t;
+
+/**
+ * struct cp_opts_s - Command line options of the cp tool
+ * @async: -a, overlap reads and writes with a reader thread when the data
+ *         has to go through user space
+ * @recursive: -r, copy a directory tree
+ * @nocache: -c, keep the copied data out of the page cache
+ * @sync: -s none|end|N, fdatasync policy of the destination
+ * @sync_bytes: flush interval in bytes for CP_SYNC_EVERY (-s N, in MiB)
+ * @checksum: -k or -K, checksum the data while copying it
+ * @buffered: -b, skip the kernel copy paths and go through a user buffer
+ *            (two with -a), as a checksum does, without checksumming
+ */
+typedef struct cp_opts_s
+{
+	int async;
+	int recursive;
+	int nocache;
+	cp_sync_t sync;
+	off_t sync_bytes;
+	cp_sum_t checksum;
+	int buffered;
+} cp_opts_t;
+
+/**
+ * struct cp_flow_s - One file being copied
+ * @from: source file descriptor
+ * @to: destination file descriptor
+ * @opts: command line options
+ * @unsynced: bytes written since the last fdatasync
+ * @prev_off: offset of the previous chunk written, for write-behind
+ * @prev_len: length of the previous chunk written, 0 if none
+ * @crc: CRC32C of the data written so far, with opts->checksum
+ */
+typedef struct cp_flow_s
+{
+	int from;
+	int to;
+	const cp_opts_t *opts;
+	off_t unsynced;
+	off_t prev_off;
+	off_t prev_len;
+	uint32_t crc;
+} cp_flow_t;
+
+/**
+ * struct cp_job_s - One path of a tree copy
+ * @src: source path
+ * @dst: destination path
+ */
+typedef struct cp_job_s
+{
+	char *src;
+	char *dst;
+} cp_job_t;
+
+/**
+ * struct cp_deque_s - Jobs queued by one worker
+ * @lock: protects the deque
+ * @jobs: array of jobs, live between @head and @tail
+ * @head: oldest job, taken by thieves
+ * @tail: one past the newest job, taken by the owner
+ * @cap: size of @jobs
+ */
+typedef struct cp_deque_s
+{
+	pthread_mutex_t lock;
+	cp_job_t **jobs;
+	size_t head;
+	size_t tail;
+	size_t cap;
+} cp_deque_t;
+
+/**
+ * struct cp_pool_s - Work-stealing pool of threads
+ * @deques: one deque per worker
+ * @nworkers: number of workers
+ * @lock: protects @queued and @pending, taken before a deque's lock
+ * @cond: signalled when a job is queued or the last job finishes
+ * @queued: jobs sitting in the deques
+ * @pending: jobs queued or running
+ * @idle: workers waiting after a steal round found no job, although
+ *        @queued was not 0
+ * @run: function executing one job
+ * @data: opaque pointer for @run
+ */
+typedef struct cp_pool_s
+{
+	cp_deque_t *deques;
+	int nworkers;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	long queued;
+	long pending;
+	int idle;
+	void (*run)(struct cp_pool_s *pool, int self, cp_job_t *job);
+	void *data;
+} cp_pool_t;
+
+/**
+ * struct cp_worker_s - Thread of a cp_pool_t
+ * @pool: pool the thread belongs to
+ * @self: index of the thread's deque
+ * @thread: thread handle
+ */
+typedef struct cp_worker_s
+{
+	cp_pool_t *pool;
+	int self;
+	pthread_t thread;
+} cp_worker_t;
+
+/**
+ * struct cp_dir_s - Directory whose mode and times are applied last
+ * @path: destination path
+ * @st: status of the source directory
+ * @next: next directory, deeper ones first
+ */
+typedef struct cp_dir_s
+{
+	char *path;
+	struct stat st;
+	struct cp_dir_s *next;
+} cp_dir_t;
+
+/**
+ * struct cp_tree_s - State shared by the workers of a tree copy
+ * @opts: command line options
+ * @lock: protects @dirs and @status
+ * @dirs: directories created so far
+ * @files: number of files copied
+ * @bytes: number of bytes copied
+ * @status: exit code of the first error, 0 if none
+ */
+typedef struct cp_tree_s
+{
+	const cp_opts_t *opts;
+	pthread_mutex_t lock;
+	cp_dir_t *dirs;
+	unsigned long int files;
+	unsigned long int bytes;
+	int status;
+} cp_tree_t;
+
+void close_fd(int fd);
+void error(int code, const char *file, int fd1, int fd2, const char *msg);
+cp_status_t cp_copy_file_range(cp_flow_t *flow);
+cp_status_t cp_sendfile(cp_flow_t *flow);
+cp_status_t cp_buffered(cp_flow_t *flow, size_t size);
+cp_status_t cp_copy(int from, int to, const struct stat *st,
+		    const cp_opts_t *opts, uint32_t *crc);
+int cp_parse_opts(int argc, char *argv[], cp_opts_t *opts);
+size_t cp_buf_size(const struct stat *st);
+cp_status_t cp_double_buffered(cp_flow_t *flow, size_t size);
+cp_status_t cp_reflink(int from, int to);
+cp_status_t cp_sparse(cp_flow_t *flow, const struct stat *st);
+int cp_pool_push(cp_pool_t *pool, int self, cp_job_t *job);
+int cp_pool_run(void (*run)(cp_pool_t *, int, cp_job_t *), void *data,
+		cp_job_t *job, int nworkers);
+int cp_tree(const char *src, const char *dst, const cp_opts_t *opts);
+cp_job_t *cp_job_new(const char *src, const char *dst, const char *name);
+void cp_job_free(cp_job_t *job);
+void cp_tree_fail(cp_tree_t *tree, int code, const char *msg,
+		  const char *path);
+void cp_tree_link(cp_tree_t *tree, cp_job_t *job, const struct stat *st);
+int cp_tree_finish(cp_tree_t *tree);
+int cp_parse_sync(const char *arg, cp_opts_t *opts);
+uint32_t cp_crc32c(uint32_t crc, const void *buf, size_t len);
+int cp_crc_report(const cp_opts_t *opts, const char *dst, uint32_t crc);
+void cp_flow_start(cp_flow_t *flow, const struct stat *st);
+cp_status_t cp_flow_wrote(cp_flow_t *flow, off_t off, off_t len);
+cp_status_t cp_flow_end(cp_flow_t *flow);
+
+#endif /* CP_H */
@@ -0,0 +1,174 @@
+#include "3-cp.h"
+#include <errno.h>
+#include <pthread.h>
+
+/**
+ * struct cp_ring_s - Two buffers shared by the reader and the writer
+ * @lock: protects every other field
+ * @cond: signalled whenever a buffer is filled or drained
+ * @buf: the two buffers
+ * @len: bytes read into each buffer, 0 at end of file, -1 on error
+ * @full: whether each buffer holds data not written yet
+ * @size: size of each buffer
+ * @from: source file descriptor
+ * @failed: set by the writer to stop the reader
+ */
+typedef struct cp_ring_s
+{
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	char *buf[2];
+	ssize_t len[2];
+	int full[2];
+	size_t size;
+	int from;
+	int failed;
+} cp_ring_t;
+
+/**
+ * cp_buf_size - picks a buffer size for a file
+ * @st: status of the source
+ *
+ * Description: Starts from the preferred I/O size of the file and doubles
+ * it while the file is at least 16 times larger, within CP_BUF_MIN and
+ * CP_BUF_MAX; pipes and devices get CP_BUF_MIN.
+ * Return: buffer size in bytes
+ */
+size_t cp_buf_size(const struct stat *st)
+{
+	size_t size = st->st_blksize;
+
+	if (size < CP_BUF_MIN)
+		size = CP_BUF_MIN;
+	if (!S_ISREG(st->st_mode))
+		return (size);
+
+	while (size < CP_BUF_MAX && (off_t)size * 16 <= st->st_size)
+		size <<= 1;
+
+	return (size);
+}
+
+/**
+ * cp_reader - reader thread, fills the buffers in turn
+ * @arg: shared cp_ring_t
+ *
+ * Return: NULL
+ */
+static void *cp_reader(void *arg)
+{
+	cp_ring_t *ring = arg;
+	ssize_t r;
+	int i = 0, failed;
+
+	do {
+		pthread_mutex_lock(&ring->lock);
+		while (ring->full[i] && !ring->failed)
+			pthread_cond_wait(&ring->cond, &ring->lock);
+		failed = ring->failed;
+		pthread_mutex_unlock(&ring->lock);
+		if (failed)
+			break;
+
+		do {
+			r = read(ring->from, ring->buf[i], ring->size);
+		} while (r == -1 && errno == EINTR);
+
+		pthread_mutex_lock(&ring->lock);
+		ring->len[i] = r;
+		ring->full[i] = 1;
+		pthread_cond_signal(&ring->cond);
+		pthread_mutex_unlock(&ring->lock);
+		i ^= 1;
+	} while (r > 0);
+
+	return (NULL);
+}
+
+/**
+ * cp_writer - drains the buffers in turn as the reader fills them
+ * @ring: shared buffers
+ * @flow: file being copied
+ *
+ * Return: CP_DONE, CP_EREAD or CP_EWRITE
+ */
+static cp_status_t cp_writer(cp_ring_t *ring, cp_flow_t *flow)
+{
+	ssize_t off, w;
+	off_t total = 0;
+	int i = 0;
+
+	for (;; i ^= 1)
+	{
+		pthread_mutex_lock(&ring->lock);
+		while (!ring->full[i])
+			pthread_cond_wait(&ring->cond, &ring->lock);
+		pthread_mutex_unlock(&ring->lock);
+		if (ring->len[i] <= 0)
+			return (ring->len[i] == 0 ? CP_DONE : CP_EREAD);
+
+		for (off = 0; off < ring->len[i]; off += w)
+		{
+			w = write(flow->to, ring->buf[i] + off, ring->len[i] - off);
+			if (w == -1 && errno == EINTR)
+				w = 0;
+			else if (w <= 0)
+				return (CP_EWRITE);
+		}
+		if (flow->opts->checksum != CP_SUM_NONE)
+			flow->crc = cp_crc32c(flow->crc, ring->buf[i], ring->len[i]);
+		if (cp_flow_wrote(flow, total, ring->len[i]) != CP_DONE)
+			return (CP_EWRITE);
+		total += ring->len[i];
+
+		pthread_mutex_lock(&ring->lock);
+		ring->full[i] = 0;
+		pthread_cond_signal(&ring->cond);
+		pthread_mutex_unlock(&ring->lock);
+	}
+}
+
+/**
+ * cp_double_buffered - copies with reads and writes overlapped
+ * @flow: file being copied
+ * @size: size of each of the two buffers
+ *
+ * Description: A reader thread fills one buffer while the calling thread
+ * writes the other, so the source and the destination are kept busy at
+ * the same time.
+ * Return: CP_DONE, CP_EREAD, CP_EWRITE, or CP_UNSUPPORTED if the thread
+ *         or the buffers could not be set up
+ */
+cp_status_t cp_double_buffered(cp_flow_t *flow, size_t size)
+{
+	cp_ring_t ring;
+	pthread_t reader;
+	cp_status_t status = CP_UNSUPPORTED;
+
+	ring.buf[0] = malloc(size);
+	ring.buf[1] = malloc(size);
+	ring.full[0] = 0;
+	ring.full[1] = 0;
+	ring.size = size;
+	ring.from = flow->from;
+	ring.failed = 0;
+	pthread_mutex_init(&ring.lock, NULL);
+	pthread_cond_init(&ring.cond, NULL);
+
+	if (ring.buf[0] != NULL && ring.buf[1] != NULL &&
+	    pthread_create(&reader, NULL, cp_reader, &ring) == 0)
+	{
+		status = cp_writer(&ring, flow);
+		pthread_mutex_lock(&ring.lock);
+		ring.failed = 1;
+		pthread_cond_signal(&ring.cond);
+		pthread_mutex_unlock(&ring.lock);
+		pthread_join(reader, NULL);
+	}
+
+	pthread_cond_destroy(&ring.cond);
+	pthread_mutex_destroy(&ring.lock);
+	free(ring.buf[0]);
+	free(ring.buf[1]);
+	return (status);
+}
@@ -0,0 +1,173 @@
+#include "3-cp.h"
+#include <errno.h>
+#include <sys/sendfile.h>
+
+/**
+ * cp_copy_file_range - copies from one fd to another inside the kernel
+ * @flow: file being copied
+ *
+ * Description: copy_file_range moves the data between page caches (or lets
+ * the filesystem share extents) without it ever reaching user space.
+ * Return: CP_DONE, CP_EREAD, CP_EWRITE, or CP_UNSUPPORTED when the kernel
+ *         or filesystem cannot do it (the file offsets stay consistent)
+ */
+cp_status_t cp_copy_file_range(cp_flow_t *flow)
+{
+	ssize_t n;
+	loff_t off = 0;
+	cp_status_t status;
+
+	while ((n = copy_file_range(flow->from, NULL, flow->to, &off,
+				    CP_BUF_SIZE, 0)) != 0)
+	{
+		if (n > 0)
+		{
+			status = cp_flow_wrote(flow, off - n, n);
+			if (status != CP_DONE)
+				return (status);
+			continue;
+		}
+		if (errno == EINTR)
+			continue;
+		if (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+		    errno == EOPNOTSUPP || errno == EBADF)
+			return (off == 0 ? CP_UNSUPPORTED : CP_EREAD);
+		if (errno == ENOSPC || errno == EDQUOT || errno == EFBIG)
+			return (CP_EWRITE);
+		return (CP_EREAD);
+	}
+
+	return (CP_DONE);
+}
+
+/**
+ * cp_sendfile - copies from one fd to another with sendfile
+ * @flow: file being copied
+ *
+ * Return: CP_DONE, CP_EREAD, CP_EWRITE or CP_UNSUPPORTED
+ */
+cp_status_t cp_sendfile(cp_flow_t *flow)
+{
+	ssize_t n;
+	off_t off = 0;
+	cp_status_t status;
+
+	while ((n = sendfile(flow->to, flow->from, NULL, CP_BUF_SIZE)) != 0)
+	{
+		if (n > 0)
+		{
+			status = cp_flow_wrote(flow, off, n);
+			if (status != CP_DONE)
+				return (status);
+			off += n;
+			continue;
+		}
+		if (errno == EINTR || errno == EAGAIN)
+			continue;
+		if (errno == ENOSYS || errno == EINVAL)
+			return (off == 0 ? CP_UNSUPPORTED : CP_EREAD);
+		if (errno == ENOSPC || errno == EDQUOT || errno == EFBIG ||
+		    errno == EPIPE)
+			return (CP_EWRITE);
+		return (CP_EREAD);
+	}
+
+	return (CP_DONE);
+}
+
+/**
+ * cp_buffered - copies from one fd to another through a user buffer
+ * @flow: file being copied
+ * @size: size of the buffer
+ *
+ * Return: CP_DONE, CP_EREAD or CP_EWRITE
+ */
+cp_status_t cp_buffered(cp_flow_t *flow, size_t size)
+{
+	char *buf;
+	ssize_t r, w, off;
+	off_t total = 0;
+	cp_status_t status = CP_DONE;
+
+	buf = malloc(size);
+	if (buf == NULL)
+		return (CP_EREAD);
+
+	while (status == CP_DONE && (r = read(flow->from, buf, size)) != 0)
+	{
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r == -1)
+			status = CP_EREAD;
+		for (off = 0; status == CP_DONE && off < r; off += w)
+		{
+			w = write(flow->to, buf + off, r - off);
+			if (w == -1 && errno == EINTR)
+				w = 0;
+			else if (w <= 0)
+				status = CP_EWRITE;
+		}
+		if (status == CP_DONE && flow->opts->checksum != CP_SUM_NONE)
+			flow->crc = cp_crc32c(flow->crc, buf, r);
+		if (status == CP_DONE)
+			status = cp_flow_wrote(flow, total, r);
+		total += r;
+	}
+
+	free(buf);
+	return (status);
+}
+
+/**
+ * cp_copy - copies a whole file with the cheapest strategy available
+ * @from: source file descriptor
+ * @to: destination file descriptor
+ * @st: status of the source
+ * @opts: command line options
+ *
+ * @crc: receives the CRC32C of the data when opts->checksum is set,
+ *       may be NULL
+ *
+ * Description: Tries a reflink, then a hole-preserving copy for sparse
+ * files, then copy_file_range, then sendfile, then a user buffer sized by
+ * cp_buf_size (two of them with -a). Files reporting a zero size
+ * (procfs, sysfs) and non-regular files always go through the buffer, as
+ * the kernel paths would stop at the reported size. A checksum needs to
+ * see the data, so it also forces the buffer, as -b does; holes are then
+ * written out.
+ * Return: CP_DONE, CP_EREAD or CP_EWRITE
+ */
+cp_status_t cp_copy(int from, int to, const struct stat *st,
+		    const cp_opts_t *opts, uint32_t *crc)
+{
+	cp_status_t status = CP_UNSUPPORTED;
+	cp_flow_t flow;
+	int kernel = S_ISREG(st->st_mode) && st->st_size > 0 &&
+		     opts->checksum == CP_SUM_NONE && !opts->buffered;
+
+	flow.from = from;
+	flow.to = to;
+	flow.opts = opts;
+	flow.crc = 0;
+	if (kernel)
+		status = cp_reflink(from, to);
+	if (status == CP_UNSUPPORTED)
+		cp_flow_start(&flow, st);
+	if (kernel)
+	{
+		if (status == CP_UNSUPPORTED)
+			status = cp_sparse(&flow, st);
+		if (status == CP_UNSUPPORTED)
+			status = cp_copy_file_range(&flow);
+		if (status == CP_UNSUPPORTED)
+			status = cp_sendfile(&flow);
+	}
+	if (status == CP_UNSUPPORTED && opts->async)
+		status = cp_double_buffered(&flow, cp_buf_size(st));
+	if (status == CP_UNSUPPORTED)
+		status = cp_buffered(&flow, cp_buf_size(st));
+	if (crc != NULL)
+		*crc = flow.crc;
+
+	return (status == CP_DONE ? cp_flow_end(&flow) : status);
+}
@@ -0,0 +1,138 @@
+#include "3-cp.h"
+#include <string.h>
+
+/* Reflected Castagnoli polynomial, as used by iSCSI, ext4 and SSE4.2 */
+#define CP_CRC_POLY 0x82f63b78
+
+static uint32_t cp_crc_table[8][256];
+static pthread_once_t cp_crc_once = PTHREAD_ONCE_INIT;
+
+/**
+ * cp_crc_init - fills the slicing-by-8 tables
+ */
+static void cp_crc_init(void)
+{
+	uint32_t c;
+	int i, k;
+
+	for (i = 0; i < 256; i++)
+	{
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = (c >> 1) ^ (c & 1 ? CP_CRC_POLY : 0);
+		cp_crc_table[0][i] = c;
+	}
+	for (i = 0; i < 256; i++)
+		for (k = 1; k < 8; k++)
+			cp_crc_table[k][i] = (cp_crc_table[k - 1][i] >> 8) ^
+				cp_crc_table[0][cp_crc_table[k - 1][i] & 0xff];
+}
+
+/**
+ * cp_crc32c_sw - CRC32C with tables, eight bytes per step
+ * @c: running CRC, already inverted
+ * @p: data
+ * @len: length of the data
+ *
+ * Return: the updated running CRC
+ */
+static uint32_t cp_crc32c_sw(uint32_t c, const unsigned char *p, size_t len)
+{
+	pthread_once(&cp_crc_once, cp_crc_init);
+	for (; len >= 8; p += 8, len -= 8)
+	{
+		c ^= p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+		c = cp_crc_table[7][c & 0xff] ^ cp_crc_table[6][c >> 8 & 0xff] ^
+			cp_crc_table[5][c >> 16 & 0xff] ^ cp_crc_table[4][c >> 24] ^
+			cp_crc_table[3][p[4]] ^ cp_crc_table[2][p[5]] ^
+			cp_crc_table[1][p[6]] ^ cp_crc_table[0][p[7]];
+	}
+	while (len-- > 0)
+		c = (c >> 8) ^ cp_crc_table[0][(c ^ *p++) & 0xff];
+
+	return (c);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+/**
+ * cp_crc32c_hw - CRC32C with the SSE4.2 crc32 instruction
+ * @c: running CRC, already inverted
+ * @p: data
+ * @len: length of the data
+ *
+ * Return: the updated running CRC
+ */
+__attribute__((target("sse4.2")))
+static uint32_t cp_crc32c_hw(uint32_t c, const unsigned char *p, size_t len)
+{
+	uint64_t c64 = c, v;
+
+	for (; len >= 8; p += 8, len -= 8)
+	{
+		memcpy(&v, p, sizeof(v));
+		c64 = __builtin_ia32_crc32di(c64, v);
+	}
+	c = c64;
+	while (len-- > 0)
+		c = __builtin_ia32_crc32qi(c, *p++);
+
+	return (c);
+}
+#endif
+
+/**
+ * cp_crc32c - extends a CRC32C with more data
+ * @crc: CRC of the data so far, 0 to start
+ * @buf: data
+ * @len: length of the data
+ *
+ * Description: Uses the SSE4.2 instruction when the CPU has it, tables
+ * otherwise; both give the same result, so checksums can be compared
+ * across machines.
+ * Return: CRC of the data so far followed by @buf
+ */
+uint32_t cp_crc32c(uint32_t crc, const void *buf, size_t len)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+	if (__builtin_cpu_supports("sse4.2"))
+		return (~cp_crc32c_hw(~crc, buf, len));
+#endif
+	return (~cp_crc32c_sw(~crc, buf, len));
+}
+
+/**
+ * cp_crc_report - reports the checksum of a copied file
+ * @opts: command line options
+ * @dst: destination path
+ * @crc: CRC32C of the data copied
+ *
+ * Description: Writes "crc  file_to" to standard error with -k, or to
+ * file_to.crc32c with -K, naming the file by its base name there so the
+ * pair can be moved together.
+ * Return: 1 on success or without checksum, 0 if the report failed
+ */
+int cp_crc_report(const cp_opts_t *opts, const char *dst, uint32_t crc)
+{
+	const char *base = strrchr(dst, '/');
+	char *side;
+	int fd, ok;
+
+	if (opts->checksum == CP_SUM_NONE)
+		return (1);
+	if (opts->checksum == CP_SUM_STDERR)
+		return (dprintf(STDERR_FILENO, "%08x  %s\n", crc, dst) > 0);
+
+	side = malloc(strlen(dst) + sizeof(".crc32c"));
+	if (side == NULL)
+		return (0);
+	sprintf(side, "%s.crc32c", dst);
+	fd = open(side, O_WRONLY | O_CREAT | O_TRUNC, 0664);
+	free(side);
+	if (fd == -1)
+		return (0);
+	ok = dprintf(fd, "%08x  %s\n", crc, base ? base + 1 : dst) > 0;
+	if (close(fd) == -1)
+		ok = 0;
+
+	return (ok);
+}
@@ -0,0 +1,192 @@
+#include "3-cp.h"
+#include <string.h>
+
+/**
+ * cp_pool_push - queues a job on the deque of a worker
+ * @pool: worker pool
+ * @self: index of the calling worker
+ * @job: job to queue, owned by the pool until it has run
+ *
+ * Description: pool->lock is held from before the job is visible in the
+ * deque until it is counted, so a thief that takes and finishes it at
+ * once cannot drop pending to 0 nor queued below 0 in between.
+ * Return: 1 on success, 0 on failure (the job is not queued)
+ */
+int cp_pool_push(cp_pool_t *pool, int self, cp_job_t *job)
+{
+	cp_deque_t *dq = &pool->deques[self];
+	cp_job_t **jobs;
+	size_t n;
+
+	pthread_mutex_lock(&pool->lock);
+	pthread_mutex_lock(&dq->lock);
+	if (dq->tail == dq->cap && dq->head > 0)
+	{
+		n = dq->tail - dq->head;
+		memmove(dq->jobs, dq->jobs + dq->head, n * sizeof(*jobs));
+		dq->head = 0;
+		dq->tail = n;
+	}
+	if (dq->tail == dq->cap)
+	{
+		jobs = realloc(dq->jobs, (dq->cap * 2 + 16) * sizeof(*jobs));
+		if (jobs == NULL)
+		{
+			pthread_mutex_unlock(&dq->lock);
+			pthread_mutex_unlock(&pool->lock);
+			return (0);
+		}
+		dq->jobs = jobs;
+		dq->cap = dq->cap * 2 + 16;
+	}
+	dq->jobs[dq->tail++] = job;
+	pthread_mutex_unlock(&dq->lock);
+
+	pool->queued++;
+	pool->pending++;
+	pthread_cond_signal(&pool->cond);
+	pthread_mutex_unlock(&pool->lock);
+	return (1);
+}
+
+/**
+ * cp_pool_take - takes the next job for a worker
+ * @pool: worker pool
+ * @self: index of the calling worker
+ *
+ * Description: A worker pops the newest job of its own deque, which keeps
+ * the walk depth-first and the paths it touches hot; when it has nothing
+ * left it steals the oldest job of another worker, usually a whole
+ * directory, so one steal moves a large share of the remaining work.
+ * Return: a job, or NULL if every deque is empty
+ */
+static cp_job_t *cp_pool_take(cp_pool_t *pool, int self)
+{
+	cp_deque_t *dq;
+	cp_job_t *job = NULL;
+	int i, victim;
+
+	for (i = 0; i < pool->nworkers && job == NULL; i++)
+	{
+		victim = (self + i) % pool->nworkers;
+		dq = &pool->deques[victim];
+		pthread_mutex_lock(&dq->lock);
+		if (dq->head < dq->tail)
+			job = (i == 0) ? dq->jobs[--dq->tail] : dq->jobs[dq->head++];
+		pthread_mutex_unlock(&dq->lock);
+	}
+
+	if (job != NULL)
+	{
+		pthread_mutex_lock(&pool->lock);
+		pool->queued--;
+		if (pool->idle > 0)
+			pthread_cond_broadcast(&pool->cond);
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return (job);
+}
+
+/**
+ * cp_pool_worker - runs jobs until every queued job has finished
+ * @arg: cp_worker_t of this thread
+ *
+ * Description: A steal round can find every deque empty while queued is
+ * not 0, when a thief has taken the last job but not counted it yet, or
+ * a job was pushed to a deque already visited; the worker then sleeps
+ * until the next take, push or end instead of spinning.
+ * Return: NULL
+ */
+static void *cp_pool_worker(void *arg)
+{
+	cp_worker_t *worker = arg;
+	cp_pool_t *pool = worker->pool;
+	cp_job_t *job;
+
+	for (;;)
+	{
+		job = cp_pool_take(pool, worker->self);
+		if (job != NULL)
+		{
+			pool->run(pool, worker->self, job);
+			pthread_mutex_lock(&pool->lock);
+			if (--pool->pending == 0)
+				pthread_cond_broadcast(&pool->cond);
+			pthread_mutex_unlock(&pool->lock);
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->lock);
+		if (pool->queued > 0 && pool->pending > 0)
+		{
+			pool->idle++;
+			pthread_cond_wait(&pool->cond, &pool->lock);
+			pool->idle--;
+		}
+		while (pool->queued == 0 && pool->pending > 0)
+			pthread_cond_wait(&pool->cond, &pool->lock);
+		if (pool->pending == 0)
+		{
+			pthread_mutex_unlock(&pool->lock);
+			return (NULL);
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+/**
+ * cp_pool_run - runs a job and everything it spawns on a worker pool
+ * @run: function executing one job; it owns and frees the job
+ * @data: opaque pointer stored in pool->data for @run
+ * @job: first job
+ * @nworkers: number of threads
+ *
+ * Return: 1 once every job has run, 0 if the pool could not be set up
+ *         (the first job has not run and still belongs to the caller)
+ */
+int cp_pool_run(void (*run)(cp_pool_t *, int, cp_job_t *), void *data,
+		cp_job_t *job, int nworkers)
+{
+	cp_pool_t pool;
+	cp_worker_t *workers;
+	int i, started = 0, ok = 0;
+
+	memset(&pool, 0, sizeof(pool));
+	pool.run = run;
+	pool.data = data;
+	pool.nworkers = nworkers;
+	pool.deques = calloc(nworkers, sizeof(cp_deque_t));
+	workers = calloc(nworkers, sizeof(cp_worker_t));
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.cond, NULL);
+	for (i = 0; pool.deques != NULL && i < nworkers; i++)
+		pthread_mutex_init(&pool.deques[i].lock, NULL);
+
+	if (pool.deques != NULL && workers != NULL && cp_pool_push(&pool, 0, job))
+	{
+		for (; started < nworkers; started++)
+		{
+			workers[started].pool = &pool;
+			workers[started].self = started;
+			if (pthread_create(&workers[started].thread, NULL,
+					   cp_pool_worker, &workers[started]) != 0)
+				break;
+		}
+		if (started == 0)
+			cp_pool_worker(&workers[0]);
+		for (i = 0; i < started; i++)
+			pthread_join(workers[i].thread, NULL);
+		ok = 1;
+	}
+
+	for (i = 0; pool.deques != NULL && i < nworkers; i++)
+	{
+		pthread_mutex_destroy(&pool.deques[i].lock);
+		free(pool.deques[i].jobs);
+	}
+	pthread_cond_destroy(&pool.cond);
+	pthread_mutex_destroy(&pool.lock);
+	free(pool.deques);
+	free(workers);
+	return (ok);
+}
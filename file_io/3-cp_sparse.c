@@ -0,0 +1,109 @@
+#include "3-cp.h"
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+
+/**
+ * cp_reflink - makes the destination share the extents of the source
+ * @from: source file descriptor
+ * @to: destination file descriptor
+ *
+ * Description: On copy-on-write filesystems (Btrfs, XFS, bcachefs) FICLONE
+ * only updates metadata, whatever the size of the file.
+ * Return: CP_DONE, or CP_UNSUPPORTED if the filesystem cannot clone
+ */
+cp_status_t cp_reflink(int from, int to)
+{
+	if (ioctl(to, FICLONE, from) == 0)
+		return (CP_DONE);
+
+	return (CP_UNSUPPORTED);
+}
+
+/**
+ * cp_copy_range - copies one byte range at the same offset
+ * @flow: file being copied
+ * @off: offset of the range
+ * @len: length of the range
+ *
+ * Return: CP_DONE, CP_EREAD or CP_EWRITE
+ */
+static cp_status_t cp_copy_range(cp_flow_t *flow, off_t off, off_t len)
+{
+	loff_t in = off, out = off;
+	ssize_t n, w, k;
+	cp_status_t status = CP_DONE;
+	char buf[1 << 16];
+
+	while (status == CP_DONE && len > 0)
+	{
+		n = copy_file_range(flow->from, &in, flow->to, &out,
+				    len < CP_BUF_SIZE ? len : CP_BUF_SIZE, 0);
+		if (n <= 0)
+			break;
+		status = cp_flow_wrote(flow, in - n, n);
+		len -= n;
+	}
+	while (status == CP_DONE && len > 0)
+	{
+		n = pread(flow->from, buf,
+			  len < (off_t)sizeof(buf) ? len : (off_t)sizeof(buf), in);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return (CP_EREAD);
+		for (w = 0; w < n; w += k)
+		{
+			k = pwrite(flow->to, buf + w, n - w, in + w);
+			if (k == -1 && errno == EINTR)
+				k = 0;
+			else if (k <= 0)
+				return (CP_EWRITE);
+		}
+		status = cp_flow_wrote(flow, in, n);
+		in += n;
+		len -= n;
+	}
+
+	return (status);
+}
+
+/**
+ * cp_sparse - copies only the data regions of a file with holes
+ * @flow: file being copied, into an empty destination
+ * @st: status of the source
+ *
+ * Description: Walks the source with SEEK_DATA/SEEK_HOLE, copies each data
+ * region to the same offset and extends the destination to the source size
+ * at the end, so every hole stays a hole. Only used when the source has
+ * fewer blocks allocated than its size implies.
+ * Return: CP_DONE, CP_EREAD, CP_EWRITE, or CP_UNSUPPORTED
+ */
+cp_status_t cp_sparse(cp_flow_t *flow, const struct stat *st)
+{
+	off_t data, hole = 0;
+	cp_status_t status;
+
+	if (!S_ISREG(st->st_mode) || (off_t)st->st_blocks * 512 >= st->st_size)
+		return (CP_UNSUPPORTED);
+
+	while (hole < st->st_size)
+	{
+		data = lseek(flow->from, hole, SEEK_DATA);
+		if (data == -1 && errno == ENXIO)
+			break;
+		if (data == -1)
+			return (hole == 0 ? CP_UNSUPPORTED : CP_EREAD);
+		hole = lseek(flow->from, data, SEEK_HOLE);
+		if (hole == -1)
+			return (CP_EREAD);
+		status = cp_copy_range(flow, data, hole - data);
+		if (status != CP_DONE)
+			return (status);
+	}
+
+	if (ftruncate(flow->to, st->st_size) == -1)
+		return (CP_EWRITE);
+
+	return (CP_DONE);
+}
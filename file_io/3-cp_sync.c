@@ -0,0 +1,123 @@
+#include "3-cp.h"
+#include <string.h>
+
+/**
+ * cp_parse_sync - parses the argument of -s
+ * @arg: "none", "end", or a number of MiB between two fdatasync calls
+ * @opts: options to fill
+ *
+ * Return: 1 on success, 0 if @arg is not a valid policy
+ */
+int cp_parse_sync(const char *arg, cp_opts_t *opts)
+{
+	char *end;
+	long mib;
+
+	if (arg == NULL)
+		return (0);
+	if (strcmp(arg, "none") == 0)
+		opts->sync = CP_SYNC_NONE;
+	else if (strcmp(arg, "end") == 0)
+		opts->sync = CP_SYNC_END;
+	else
+	{
+		mib = strtol(arg, &end, 10);
+		if (*arg == '\0' || *end != '\0' || mib <= 0)
+			return (0);
+		opts->sync = CP_SYNC_EVERY;
+		opts->sync_bytes = (off_t)mib << 20;
+	}
+
+	return (1);
+}
+
+/**
+ * cp_flow_start - prepares a copy that writes the destination in order
+ * @flow: file being copied, from/to/opts already set
+ * @st: status of the source
+ *
+ * Description: Announces a sequential read to the kernel and, unless the
+ * source has holes to preserve, reserves its size on the destination in
+ * one go so the filesystem can lay it out contiguously. FALLOC_FL_KEEP_SIZE
+ * keeps a copy cut short from looking complete. Both are hints: a
+ * filesystem that refuses them still gets a correct copy.
+ */
+void cp_flow_start(cp_flow_t *flow, const struct stat *st)
+{
+	flow->unsynced = 0;
+	flow->prev_len = 0;
+
+	posix_fadvise(flow->from, 0, 0, POSIX_FADV_SEQUENTIAL);
+	if (S_ISREG(st->st_mode) && st->st_size > 0 &&
+	    (off_t)st->st_blocks * 512 >= st->st_size)
+		fallocate(flow->to, FALLOC_FL_KEEP_SIZE, 0, st->st_size);
+}
+
+/**
+ * cp_flow_wrote - applies the sync and cache policies to a written chunk
+ * @flow: file being copied
+ * @off: offset of the chunk in both files
+ * @len: length of the chunk
+ *
+ * Description: With -c the chunk is queued for writeback right away and
+ * the previous one, by now on disk, is waited for and dropped from the
+ * page cache on both sides; with -s N the destination is flushed every
+ * N MiB.
+ * Return: CP_DONE, or CP_EWRITE if flushing failed
+ */
+cp_status_t cp_flow_wrote(cp_flow_t *flow, off_t off, off_t len)
+{
+	if (flow->opts->nocache)
+	{
+		sync_file_range(flow->to, off, len, SYNC_FILE_RANGE_WRITE);
+		if (flow->prev_len > 0)
+		{
+			sync_file_range(flow->to, flow->prev_off, flow->prev_len,
+					SYNC_FILE_RANGE_WAIT_BEFORE |
+					SYNC_FILE_RANGE_WRITE |
+					SYNC_FILE_RANGE_WAIT_AFTER);
+			posix_fadvise(flow->to, flow->prev_off, flow->prev_len,
+				      POSIX_FADV_DONTNEED);
+			posix_fadvise(flow->from, flow->prev_off, flow->prev_len,
+				      POSIX_FADV_DONTNEED);
+		}
+		flow->prev_off = off;
+		flow->prev_len = len;
+	}
+
+	flow->unsynced += len;
+	if (flow->opts->sync == CP_SYNC_EVERY &&
+	    flow->unsynced >= flow->opts->sync_bytes)
+	{
+		if (fdatasync(flow->to) == -1)
+			return (CP_EWRITE);
+		flow->unsynced = 0;
+	}
+
+	return (CP_DONE);
+}
+
+/**
+ * cp_flow_end - finishes a copy according to the sync and cache policies
+ * @flow: file being copied
+ *
+ * Return: CP_DONE, or CP_EWRITE if the final flush failed
+ */
+cp_status_t cp_flow_end(cp_flow_t *flow)
+{
+	if (flow->opts->sync != CP_SYNC_NONE && fdatasync(flow->to) == -1)
+		return (CP_EWRITE);
+
+	if (flow->opts->nocache)
+	{
+		if (flow->opts->sync == CP_SYNC_NONE)
+			sync_file_range(flow->to, 0, 0,
+					SYNC_FILE_RANGE_WAIT_BEFORE |
+					SYNC_FILE_RANGE_WRITE |
+					SYNC_FILE_RANGE_WAIT_AFTER);
+		posix_fadvise(flow->to, 0, 0, POSIX_FADV_DONTNEED);
+		posix_fadvise(flow->from, 0, 0, POSIX_FADV_DONTNEED);
+	}
+
+	return (CP_DONE);
+}
@@ -0,0 +1,214 @@
+#include "3-cp.h"
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * cp_tree_dir - creates a directory and queues its entries
+ * @pool: worker pool
+ * @self: index of the calling worker
+ * @job: directory to copy
+ */
+static void cp_tree_dir(cp_pool_t *pool, int self, cp_job_t *job)
+{
+	cp_tree_t *tree = pool->data;
+	cp_dir_t *dir;
+	cp_job_t *child;
+	struct dirent *ent;
+	DIR *dp;
+
+	dir = malloc(sizeof(cp_dir_t));
+	if (dir == NULL || lstat(job->src, &dir->st) == -1 ||
+	    (dp = opendir(job->src)) == NULL)
+	{
+		free(dir);
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+		return;
+	}
+	if ((mkdir(job->dst, 0700) == -1 && errno != EEXIST) ||
+	    (dir->path = strdup(job->dst)) == NULL)
+	{
+		free(dir);
+		closedir(dp);
+		cp_tree_fail(tree, 99, "Error: Can't write to %s\n", job->dst);
+		return;
+	}
+	pthread_mutex_lock(&tree->lock);
+	dir->next = tree->dirs;
+	tree->dirs = dir;
+	pthread_mutex_unlock(&tree->lock);
+
+	while ((ent = readdir(dp)) != NULL)
+	{
+		if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+			continue;
+		child = cp_job_new(job->src, job->dst, ent->d_name);
+		if (child == NULL || cp_pool_push(pool, self, child) == 0)
+		{
+			cp_job_free(child);
+			cp_tree_fail(tree, 99, "Error: Can't write to %s\n", job->dst);
+		}
+	}
+	closedir(dp);
+}
+
+/**
+ * cp_tree_file - copies one regular file with its mode and times
+ * @tree: tree copy state
+ * @job: file to copy
+ */
+static void cp_tree_file(cp_tree_t *tree, cp_job_t *job)
+{
+	struct stat st;
+	struct timespec times[2];
+	cp_status_t status;
+	uint32_t crc;
+	int from, to;
+
+	from = open(job->src, O_RDONLY);
+	if (from == -1 || fstat(from, &st) == -1)
+	{
+		if (from != -1)
+			close(from);
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+		return;
+	}
+	to = open(job->dst, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	status = (to == -1) ? CP_EWRITE : cp_copy(from, to, &st, tree->opts,
+						 &crc);
+	times[0] = st.st_atim;
+	times[1] = st.st_mtim;
+	if (status == CP_DONE && (fchmod(to, st.st_mode & 07777) == -1 ||
+				  futimens(to, times) == -1))
+		status = CP_EWRITE;
+	close(from);
+	if (to != -1 && close(to) == -1)
+		status = CP_EWRITE;
+	if (status == CP_DONE && !cp_crc_report(tree->opts, job->dst, crc))
+		status = CP_EWRITE;
+
+	if (status == CP_EREAD)
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+	else if (status != CP_DONE)
+		cp_tree_fail(tree, 99, "Error: Can't write to %s\n", job->dst);
+	else
+	{
+		__sync_fetch_and_add(&tree->files, 1);
+		__sync_fetch_and_add(&tree->bytes, st.st_size);
+	}
+}
+
+/**
+ * cp_tree_run - runs one job of a tree copy
+ * @pool: worker pool
+ * @self: index of the calling worker
+ * @job: path to copy, freed here
+ */
+static void cp_tree_run(cp_pool_t *pool, int self, cp_job_t *job)
+{
+	cp_tree_t *tree = pool->data;
+	struct stat st;
+
+	if (lstat(job->src, &st) == -1)
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+	else if (S_ISDIR(st.st_mode))
+		cp_tree_dir(pool, self, job);
+	else if (S_ISREG(st.st_mode))
+		cp_tree_file(tree, job);
+	else if (S_ISLNK(st.st_mode))
+		cp_tree_link(tree, job, &st);
+	else
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+
+	cp_job_free(job);
+}
+
+/**
+ * cp_tree_inside - tells whether a destination lies inside the source
+ * @src: source directory
+ * @dst: destination directory, which may not exist yet
+ *
+ * Description: Like coreutils, compares device and inode of @src with
+ * those of @dst, or of its parent if @dst does not exist, and of each
+ * directory above it, so symbolic links and .. cannot hide a copy of a
+ * tree into itself, which would never end.
+ * Return: 1 if @dst is @src or below it, 0 otherwise
+ */
+static int cp_tree_inside(const char *src, const char *dst)
+{
+	char path[PATH_MAX], *slash;
+	struct stat top, st, up;
+	size_t len = strlen(dst);
+
+	if (stat(src, &top) == -1 || len + 1 > sizeof(path))
+		return (0);
+	strcpy(path, dst);
+	while (len > 1 && path[len - 1] == '/')
+		path[--len] = '\0';
+	if (stat(path, &st) == -1)
+	{
+		slash = strrchr(path, '/');
+		if (slash == NULL)
+			strcpy(path, ".");
+		else
+			slash[slash == path] = '\0';
+		if (stat(path, &st) == -1)
+			return (0);
+	}
+	for (len = strlen(path); len + 4 <= sizeof(path); len += 3)
+	{
+		if (st.st_dev == top.st_dev && st.st_ino == top.st_ino)
+			return (1);
+		strcpy(path + len, "/..");
+		if (stat(path, &up) == -1 ||
+		    (up.st_dev == st.st_dev && up.st_ino == st.st_ino))
+			return (0);
+		st = up;
+	}
+
+	return (0);
+}
+
+/**
+ * cp_tree - copies a directory tree with a pool of threads
+ * @src: source directory
+ * @dst: destination directory, created if needed
+ * @opts: command line options
+ *
+ * Description: Directories are listed and files copied concurrently by
+ * one worker per online CPU; a throughput summary is printed at the end.
+ * A destination inside the source is refused before anything is copied.
+ * Return: 0 on success, or the exit code of the first error (98 or 99)
+ */
+int cp_tree(const char *src, const char *dst, const cp_opts_t *opts)
+{
+	cp_tree_t tree;
+	cp_job_t *root;
+	struct timespec t0, t1;
+	double secs, mib;
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	memset(&tree, 0, sizeof(tree));
+	tree.opts = opts;
+	pthread_mutex_init(&tree.lock, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	root = cp_tree_inside(src, dst) ? NULL : cp_job_new(src, dst, NULL);
+	if (root == NULL || cp_pool_run(cp_tree_run, &tree, root,
+					n < 1 ? 1 : n > 64 ? 64 : n) == 0)
+	{
+		cp_job_free(root);
+		cp_tree_fail(&tree, 99, "Error: Can't write to %s\n", dst);
+	}
+
+	cp_tree_finish(&tree);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	mib = tree.bytes / 1048576.0;
+	printf("Copied %lu files, %.1f MiB in %.3f s (%.1f MiB/s)\n",
+	       tree.files, mib, secs, secs > 0 ? mib / secs : 0.0);
+	pthread_mutex_destroy(&tree.lock);
+	return (tree.status);
+}
@@ -0,0 +1,133 @@
+#include "3-cp.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+/**
+ * cp_job_new - creates the job copying one path of a tree
+ * @src: source path, or source directory if @name is given
+ * @dst: destination path, or destination directory if @name is given
+ * @name: entry name appended to both paths, or NULL
+ *
+ * Return: pointer to the new job, or NULL on failure
+ */
+cp_job_t *cp_job_new(const char *src, const char *dst, const char *name)
+{
+	cp_job_t *job;
+	size_t ls = strlen(src), ld = strlen(dst), ln = 0;
+
+	if (name != NULL)
+		ln = strlen(name) + 1;
+
+	job = malloc(sizeof(cp_job_t));
+	if (job == NULL)
+		return (NULL);
+	job->src = malloc(ls + ln + 1);
+	job->dst = malloc(ld + ln + 1);
+	if (job->src == NULL || job->dst == NULL)
+	{
+		cp_job_free(job);
+		return (NULL);
+	}
+
+	memcpy(job->src, src, ls + 1);
+	memcpy(job->dst, dst, ld + 1);
+	if (name != NULL)
+	{
+		job->src[ls] = '/';
+		job->dst[ld] = '/';
+		memcpy(job->src + ls + 1, name, ln);
+		memcpy(job->dst + ld + 1, name, ln);
+	}
+	return (job);
+}
+
+/**
+ * cp_job_free - frees a job
+ * @job: job to free (may be NULL)
+ */
+void cp_job_free(cp_job_t *job)
+{
+	if (job == NULL)
+		return;
+
+	free(job->src);
+	free(job->dst);
+	free(job);
+}
+
+/**
+ * cp_tree_fail - reports an error of a tree copy and keeps going
+ * @tree: tree copy state
+ * @code: exit code of the error
+ * @msg: message format expecting %s
+ * @path: path to print
+ */
+void cp_tree_fail(cp_tree_t *tree, int code, const char *msg,
+		  const char *path)
+{
+	dprintf(STDERR_FILENO, msg, path);
+
+	pthread_mutex_lock(&tree->lock);
+	if (tree->status == 0)
+		tree->status = code;
+	pthread_mutex_unlock(&tree->lock);
+}
+
+/**
+ * cp_tree_link - recreates a symbolic link with its times
+ * @tree: tree copy state
+ * @job: link to copy
+ * @st: status of the link itself
+ */
+void cp_tree_link(cp_tree_t *tree, cp_job_t *job, const struct stat *st)
+{
+	char target[PATH_MAX];
+	struct timespec times[2];
+	ssize_t n;
+
+	n = readlink(job->src, target, sizeof(target) - 1);
+	if (n == -1)
+	{
+		cp_tree_fail(tree, 98, "Error: Can't read from file %s\n", job->src);
+		return;
+	}
+	target[n] = '\0';
+
+	times[0] = st->st_atim;
+	times[1] = st->st_mtim;
+	if (symlink(target, job->dst) == -1 ||
+	    utimensat(AT_FDCWD, job->dst, times, AT_SYMLINK_NOFOLLOW) == -1)
+		cp_tree_fail(tree, 99, "Error: Can't write to %s\n", job->dst);
+}
+
+/**
+ * cp_tree_finish - applies the mode and times of the copied directories
+ * @tree: tree copy state
+ *
+ * Description: Runs once every file is in place, deepest directories
+ * first, so adding entries no longer bumps the restored times and
+ * read-only directories are only locked once filled.
+ * Return: exit code of the tree copy
+ */
+int cp_tree_finish(cp_tree_t *tree)
+{
+	cp_dir_t *dir;
+	struct timespec times[2];
+
+	while (tree->dirs != NULL)
+	{
+		dir = tree->dirs;
+		tree->dirs = dir->next;
+		times[0] = dir->st.st_atim;
+		times[1] = dir->st.st_mtim;
+		if (chmod(dir->path, dir->st.st_mode & 07777) == -1 ||
+		    utimensat(AT_FDCWD, dir->path, times, 0) == -1)
+			cp_tree_fail(tree, 99, "Error: Can't write to %s\n",
+				     dir->path);
+		free(dir->path);
+		free(dir);
+	}
+
+	return (tree->status);
+}
@@ -5,10 +5,34 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+
+/* Buffers handed to one writev call by writev_all */
+#define WRITE_IOV 64
 
 int _putchar(char c);
+int _putchar_flush(void);
+int _putbuf(const char *buf, unsigned int len);
+int _putstr(const char *s);
+int _putnum(long n);
 ssize_t read_textfile(const char *filename, size_t letters);
+ssize_t read_textfile_stream(const char *filename, size_t letters);
+ssize_t read_textfile_mmap(const char *filename, size_t letters);
+void read_textfile_mmap_clear(void);
 int create_file(const char *filename, char *text_content);
+int create_file_atomic(const char *filename, char *text_content,
+		       int durable);
+int create_files_atomic(const char **filenames, char **text_contents,
+			size_t n, int durable);
 int append_text_to_file(const char *filename, char *text_content);
+ssize_t write_all(int fd, const void *buf, size_t len);
+ssize_t writev_all(int fd, const struct iovec *iov, int iovcnt);
+int create_file_len(const char *filename, const void *buf, size_t len);
+int create_file_iov(const char *filename, const struct iovec *iov,
+		    int iovcnt);
+int append_text_to_file_len(const char *filename, const void *buf,
+			    size_t len);
+int append_text_to_file_iov(const char *filename, const struct iovec *iov,
+			    int iovcnt);
 
 #endif
@@ -2,6 +2,10 @@
 #define MAIN_H
 
 int _putchar(char c);
+int _putchar_flush(void);
+int _putbuf(const char *buf, unsigned int len);
+int _putstr(const char *s);
+int _putnum(long n);
 void print_name(char *name, void (*f)(char *));
 void array_iterator(int *array, size_t size, void (*action)(int));
 int int_index(int *array, int size, int (*cmp)(int));
@@ -1,5 +1,4 @@
 #include "main.h"
-#include <stdio.h>
 
 /**
  * print_to_98 - prints all natural numbers from n to 98
@@ -11,23 +10,12 @@
  */
 void print_to_98(int n)
 {
-	if (n <= 98)
-	{
-		while (n < 98)
-		{
-			printf("%d, ", n);
-			n++;
-		}
-		printf("%d\n", 98);
-	}
-	else
+	int step = n <= 98 ? 1 : -1;
+
+	for (; n != 98; n += step)
 	{
-		while (n > 98)
-		{
-			printf("%d, ", n);
-			n--;
-		}
-		printf("%d\n", 98);
+		_putnum(n);
+		_putbuf(", ", 2);
 	}
+	_putbuf("98\n", 3);
 }
-
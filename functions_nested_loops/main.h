@@ -2,6 +2,10 @@
 #define MAIN_H
 
 int _putchar(char c);
+int _putchar_flush(void);
+int _putbuf(const char *buf, unsigned int len);
+int _putstr(const char *s);
+int _putnum(long n);
 void print_alphabet(void);
 void print_alphabet_x10(void);
 int _islower(int c);
@@ -40,48 +40,72 @@ static shash_node_t *create_snode(const char *key, const char *value)
 	return (node);
 }
 
-/**
- * sorted_insert - insert node into sorted doubly linked list by key
- * @ht: sorted hash table
- * @node: node to insert (node->sprev/snext will be set)
+/*
+ * SHASH_DEFINE_OPS - generates the key-dependent helpers of the table
+ * @suffix: suffix appended to the generated function names
+ * @CMP: CMP(ht, a, b) orders two keys like strcmp
+ * @INDEX: INDEX(ht, key) gives the bucket of a key
+ *
+ * Instantiated once with strcmp/key_index, which the compiler inlines,
+ * and once through ht->ops, so tables created with shash_table_create
+ * never pay for an indirect call.
  */
-static void sorted_insert(shash_table_t *ht, shash_node_t *node)
-{
-	shash_node_t *cur;
-
-	if (ht->shead == NULL)
-	{
-		ht->shead = node;
-		ht->stail = node;
-		return;
-	}
-
-	cur = ht->shead;
-	while (cur != NULL && strcmp(cur->key, node->key) < 0)
-		cur = cur->snext;
-
-	if (cur == ht->shead)
-	{
-		node->snext = ht->shead;
-		ht->shead->sprev = node;
-		ht->shead = node;
-		return;
-	}
-
-	if (cur == NULL)
-	{
-		node->sprev = ht->stail;
-		ht->stail->snext = node;
-		ht->stail = node;
-		return;
-	}
-
-	node->sprev = cur->sprev;
-	node->snext = cur;
-	cur->sprev->snext = node;
-	cur->sprev = node;
+#define SHASH_DEFINE_OPS(suffix, CMP, INDEX) \
+static shash_node_t *find_##suffix(const shash_table_t *ht, const char *key, \
+				   unsigned long int *idx) \
+{ \
+	shash_node_t *node; \
+\
+	*idx = INDEX(ht, key); \
+	for (node = ht->array[*idx]; node != NULL; node = node->next) \
+		if (CMP(ht, node->key, key) == 0) \
+			return (node); \
+	return (NULL); \
+} \
+static void sorted_insert_##suffix(shash_table_t *ht, shash_node_t *node) \
+{ \
+	shash_node_t *cur; \
+\
+	if (ht->shead == NULL) \
+	{ \
+		ht->shead = node; \
+		ht->stail = node; \
+		return; \
+	} \
+	if (CMP(ht, ht->stail->key, node->key) < 0) \
+	{ \
+		node->sprev = ht->stail; \
+		ht->stail->snext = node; \
+		ht->stail = node; \
+		return; \
+	} \
+	cur = ht->shead; \
+	while (cur != NULL && CMP(ht, cur->key, node->key) < 0) \
+		cur = cur->snext; \
+	node->sprev = cur->sprev; \
+	node->snext = cur; \
+	if (cur == ht->shead) \
+		ht->shead = node; \
+	else \
+		cur->sprev->snext = node; \
+	cur->sprev = node; \
 }
 
+#define DEFAULT_CMP(ht, a, b) strcmp((a), (b))
+#define DEFAULT_INDEX(ht, key) key_index((const unsigned char *)(key), \
+					 (ht)->size)
+#define OPS_CMP(ht, a, b) ((ht)->ops->cmp((a), (b)))
+#define OPS_INDEX(ht, key) \
+	((ht)->ops->hash((const unsigned char *)(key)) % (ht)->size)
+
+/*
+ * sorted_insert_default, find_default: byte order (strcmp), djb2 buckets
+ * sorted_insert_ops, find_ops: order and buckets given by ht->ops
+ * Keys arriving in ascending order are appended to the list in O(1).
+ */
+SHASH_DEFINE_OPS(default, DEFAULT_CMP, DEFAULT_INDEX)
+SHASH_DEFINE_OPS(ops, OPS_CMP, OPS_INDEX)
+
 /**
  * shash_table_create - creates a sorted hash table
  * @size: size of the array
@@ -89,6 +113,19 @@ static void sorted_insert(shash_table_t *ht, shash_node_t *node)
  * Return: pointer to newly created table, or NULL on failure
  */
 shash_table_t *shash_table_create(unsigned long int size)
+{
+	return (shash_table_create_ops(size, NULL));
+}
+
+/**
+ * shash_table_create_ops - creates a sorted hash table with custom keys
+ * @size: size of the array
+ * @ops: key ordering and matching hash, or NULL for strcmp and djb2
+ *
+ * Return: pointer to newly created table, or NULL on failure
+ */
+shash_table_t *shash_table_create_ops(unsigned long int size,
+				      const shash_ops_t *ops)
 {
 	shash_table_t *ht;
 	unsigned long int i;
@@ -103,6 +140,7 @@ shash_table_t *shash_table_create(unsigned long int size)
 	ht->size = size;
 	ht->shead = NULL;
 	ht->stail = NULL;
+	ht->ops = ops;
 
 	ht->array = malloc(sizeof(shash_node_t *) * size);
 	if (ht->array == NULL)
@@ -136,21 +174,19 @@ int shash_table_set(shash_table_t *ht, const char *key, const char *value)
 	if (key == NULL || *key == '\0' || value == NULL)
 		return (0);
 
-	idx = key_index((const unsigned char *)key, ht->size);
+	if (ht->ops == NULL)
+		node = find_default(ht, key, &idx);
+	else
+		node = find_ops(ht, key, &idx);
 
-	node = ht->array[idx];
-	while (node != NULL)
+	if (node != NULL)
 	{
-		if (strcmp(node->key, key) == 0)
-		{
-			value_dup = strdup(value);
-			if (value_dup == NULL)
-				return (0);
-			free(node->value);
-			node->value = value_dup;
-			return (1);
-		}
-		node = node->next;
+		value_dup = strdup(value);
+		if (value_dup == NULL)
+			return (0);
+		free(node->value);
+		node->value = value_dup;
+		return (1);
 	}
 
 	node = create_snode(key, value);
@@ -160,7 +196,10 @@ int shash_table_set(shash_table_t *ht, const char *key, const char *value)
 	node->next = ht->array[idx];
 	ht->array[idx] = node;
 
-	sorted_insert(ht, node);
+	if (ht->ops == NULL)
+		sorted_insert_default(ht, node);
+	else
+		sorted_insert_ops(ht, node);
 
 	return (1);
 }
@@ -182,17 +221,12 @@ char *shash_table_get(const shash_table_t *ht, const char *key)
 	if (key == NULL || *key == '\0')
 		return (NULL);
 
-	idx = key_index((const unsigned char *)key, ht->size);
-
-	node = ht->array[idx];
-	while (node != NULL)
-	{
-		if (strcmp(node->key, key) == 0)
-			return (node->value);
-		node = node->next;
-	}
+	if (ht->ops == NULL)
+		node = find_default(ht, key, &idx);
+	else
+		node = find_ops(ht, key, &idx);
 
-	return (NULL);
+	return (node != NULL ? node->value : NULL);
 }
 
 /**
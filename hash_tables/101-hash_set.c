@@ -0,0 +1,169 @@
+#include "hash_tables.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * hash_set_create - creates a hash set
+ * @size: size of the array
+ *
+ * Return: pointer to newly created hash set, or NULL on failure
+ */
+hash_set_t *hash_set_create(unsigned long int size)
+{
+	hash_set_t *set;
+	unsigned long int i;
+
+	if (size == 0)
+		return (NULL);
+
+	set = malloc(sizeof(hash_set_t));
+	if (set == NULL)
+		return (NULL);
+
+	set->size = size;
+	set->count = 0;
+
+	set->array = malloc(sizeof(hash_set_node_t *) * size);
+	if (set->array == NULL)
+	{
+		free(set);
+		return (NULL);
+	}
+
+	for (i = 0; i < size; i++)
+		set->array[i] = NULL;
+
+	return (set);
+}
+
+/**
+ * hash_set_add - adds a key to the hash set
+ * @set: hash set
+ * @key: key (cannot be empty), duplicated into the node
+ *
+ * Return: 1 on success (or if the key is already present), 0 on failure
+ */
+int hash_set_add(hash_set_t *set, const char *key)
+{
+	unsigned long int hash, idx;
+	hash_set_node_t *node;
+	size_t len;
+
+	if (set == NULL || set->array == NULL || set->size == 0)
+		return (0);
+	if (key == NULL || *key == '\0')
+		return (0);
+
+	hash = hash_djb2((const unsigned char *)key);
+	idx = hash % set->size;
+
+	for (node = set->array[idx]; node != NULL; node = node->next)
+		if (node->hash == hash && strcmp(node->key, key) == 0)
+			return (1);
+
+	len = strlen(key);
+	node = malloc(sizeof(hash_set_node_t) + len);
+	if (node == NULL)
+		return (0);
+
+	memcpy(node->key, key, len + 1);
+	node->hash = hash;
+	node->next = set->array[idx];
+	set->array[idx] = node;
+	set->count++;
+
+	return (1);
+}
+
+/**
+ * hash_set_contains - tells whether a key is in the hash set
+ * @set: hash set
+ * @key: key to search for
+ *
+ * Return: 1 if the key is present, 0 otherwise
+ */
+int hash_set_contains(const hash_set_t *set, const char *key)
+{
+	unsigned long int hash;
+	hash_set_node_t *node;
+
+	if (set == NULL || set->array == NULL || set->size == 0)
+		return (0);
+	if (key == NULL || *key == '\0')
+		return (0);
+
+	hash = hash_djb2((const unsigned char *)key);
+
+	node = set->array[hash % set->size];
+	while (node != NULL)
+	{
+		if (node->hash == hash && strcmp(node->key, key) == 0)
+			return (1);
+		node = node->next;
+	}
+
+	return (0);
+}
+
+/**
+ * hash_set_remove - removes a key from the hash set
+ * @set: hash set
+ * @key: key to remove
+ *
+ * Return: 1 if the key was removed, 0 if it was not present
+ */
+int hash_set_remove(hash_set_t *set, const char *key)
+{
+	unsigned long int hash;
+	hash_set_node_t **link, *node;
+
+	if (set == NULL || set->array == NULL || set->size == 0)
+		return (0);
+	if (key == NULL || *key == '\0')
+		return (0);
+
+	hash = hash_djb2((const unsigned char *)key);
+
+	link = &set->array[hash % set->size];
+	while (*link != NULL)
+	{
+		node = *link;
+		if (node->hash == hash && strcmp(node->key, key) == 0)
+		{
+			*link = node->next;
+			free(node);
+			set->count--;
+			return (1);
+		}
+		link = &node->next;
+	}
+
+	return (0);
+}
+
+/**
+ * hash_set_delete - deletes a hash set
+ * @set: hash set
+ */
+void hash_set_delete(hash_set_t *set)
+{
+	unsigned long int i;
+	hash_set_node_t *node, *tmp;
+
+	if (set == NULL)
+		return;
+
+	for (i = 0; i < set->size; i++)
+	{
+		node = set->array[i];
+		while (node != NULL)
+		{
+			tmp = node->next;
+			free(node);
+			node = tmp;
+		}
+	}
+
+	free(set->array);
+	free(set);
+}
@@ -0,0 +1,140 @@
+#include "hash_tables.h"
+#include <stdio.h>
+
+/**
+ * hash_set_foreach - calls a function on every key of a hash set
+ * @set: hash set
+ * @action: function called with each key and @data
+ * @data: opaque pointer passed through to @action
+ */
+void hash_set_foreach(const hash_set_t *set,
+		      void (*action)(const char *key, void *data), void *data)
+{
+	unsigned long int i;
+	hash_set_node_t *node;
+
+	if (set == NULL || action == NULL)
+		return;
+
+	for (i = 0; i < set->size; i++)
+	{
+		for (node = set->array[i]; node != NULL; node = node->next)
+			action(node->key, data);
+	}
+}
+
+/**
+ * print_key - prints one key of a hash set
+ * @key: key to print
+ * @data: pointer to the "first element" flag
+ */
+static void print_key(const char *key, void *data)
+{
+	int *first = data;
+
+	if (*first == 0)
+		printf(", ");
+	printf("'%s'", key);
+	*first = 0;
+}
+
+/**
+ * hash_set_print - prints a hash set
+ * @set: hash set
+ */
+void hash_set_print(const hash_set_t *set)
+{
+	int first = 1;
+
+	if (set == NULL)
+		return;
+
+	printf("{");
+	hash_set_foreach(set, print_key, &first);
+	printf("}\n");
+}
+
+/**
+ * hash_set_union - creates a set holding the keys of two sets
+ * @a: first hash set
+ * @b: second hash set
+ *
+ * Return: pointer to the new set, or NULL on failure
+ */
+hash_set_t *hash_set_union(const hash_set_t *a, const hash_set_t *b)
+{
+	const hash_set_t *src[2];
+	hash_set_t *set;
+	hash_set_node_t *node;
+	unsigned long int i;
+	int s;
+
+	if (a == NULL || b == NULL)
+		return (NULL);
+
+	set = hash_set_create(a->size > b->size ? a->size : b->size);
+	if (set == NULL)
+		return (NULL);
+
+	src[0] = a;
+	src[1] = b;
+	for (s = 0; s < 2; s++)
+	{
+		for (i = 0; i < src[s]->size; i++)
+		{
+			node = src[s]->array[i];
+			for (; node != NULL; node = node->next)
+			{
+				if (hash_set_add(set, node->key) == 0)
+				{
+					hash_set_delete(set);
+					return (NULL);
+				}
+			}
+		}
+	}
+
+	return (set);
+}
+
+/**
+ * hash_set_intersection - creates a set holding the keys common to two sets
+ * @a: first hash set
+ * @b: second hash set
+ *
+ * Description: Walks the smaller set and probes the larger one.
+ * Return: pointer to the new set, or NULL on failure
+ */
+hash_set_t *hash_set_intersection(const hash_set_t *a, const hash_set_t *b)
+{
+	const hash_set_t *small, *big;
+	hash_set_t *set;
+	hash_set_node_t *node;
+	unsigned long int i;
+
+	if (a == NULL || b == NULL)
+		return (NULL);
+
+	small = (a->count <= b->count) ? a : b;
+	big = (small == a) ? b : a;
+
+	set = hash_set_create(small->size);
+	if (set == NULL)
+		return (NULL);
+
+	for (i = 0; i < small->size; i++)
+	{
+		for (node = small->array[i]; node != NULL; node = node->next)
+		{
+			if (hash_set_contains(big, node->key) == 0)
+				continue;
+			if (hash_set_add(set, node->key) == 0)
+			{
+				hash_set_delete(set);
+				return (NULL);
+			}
+		}
+	}
+
+	return (set);
+}
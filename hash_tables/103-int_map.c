@@ -0,0 +1,39 @@
+#include "int_map.h"
+
+/**
+ * int_map_mix32 - scrambles a 32-bit key (lowbias32 finalizer)
+ * @key: key to scramble
+ *
+ * Return: well-distributed hash of @key
+ */
+unsigned long int int_map_mix32(uint32_t key)
+{
+	key ^= key >> 16;
+	key *= 0x7feb352dU;
+	key ^= key >> 15;
+	key *= 0x846ca68bU;
+	key ^= key >> 16;
+
+	return (key);
+}
+
+/**
+ * int_map_mix64 - scrambles a 64-bit key (murmur3 fmix64 finalizer)
+ * @key: key to scramble
+ *
+ * Return: well-distributed hash of @key
+ */
+unsigned long int int_map_mix64(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdUL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53UL;
+	key ^= key >> 33;
+
+	return ((unsigned long int)key);
+}
+
+INT_MAP_DEFINE(u32_map, uint32_t, void *, int_map_mix32)
+INT_MAP_DEFINE(u64_map, uint64_t, void *, int_map_mix64)
+INT_MAP_DEFINE(u64_u64_map, uint64_t, uint64_t, int_map_mix64)
@@ -0,0 +1,218 @@
+#include "hash_tables.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * ohash_lookup - finds the index slot of a key
+ * @ht: insertion-ordered hash table
+ * @key: key to search for
+ * @hash: djb2 hash of @key
+ * @slot: set to the slot holding @key, or to the slot to insert it into
+ *
+ * Return: position of the entry in ht->entries, or -1 if not found
+ */
+static long int ohash_lookup(const ohash_table_t *ht, const char *key,
+			     unsigned long int hash, unsigned long int *slot)
+{
+	unsigned long int i, mask = ht->size - 1;
+	long int free_slot = -1;
+	int pos;
+
+	for (i = hash & mask; ; i = (i + 1) & mask)
+	{
+		pos = ht->index[i];
+		if (pos == OHASH_EMPTY)
+		{
+			*slot = (free_slot == -1) ? i : (unsigned long int)free_slot;
+			return (-1);
+		}
+		if (pos == OHASH_DUMMY)
+		{
+			if (free_slot == -1)
+				free_slot = i;
+			continue;
+		}
+		if (ht->entries[pos].hash == hash &&
+		    strcmp(ht->entries[pos].key, key) == 0)
+		{
+			*slot = i;
+			return (pos);
+		}
+	}
+}
+
+/**
+ * ohash_rebuild - compacts the entries and rebuilds the index
+ * @ht: insertion-ordered hash table
+ * @size: new number of index slots (a power of two)
+ *
+ * Return: 1 on success, 0 on failure (the table is left untouched)
+ */
+static int ohash_rebuild(ohash_table_t *ht, unsigned long int size)
+{
+	unsigned long int i, j, n = 0, capacity = size * 2 / 3;
+	ohash_entry_t *entries;
+	int *index;
+
+	index = malloc(sizeof(int) * size);
+	entries = malloc(sizeof(ohash_entry_t) * capacity);
+	if (index == NULL || entries == NULL)
+	{
+		free(index);
+		free(entries);
+		return (0);
+	}
+	memset(index, 0xff, sizeof(int) * size);
+
+	for (i = 0; i < ht->used; i++)
+	{
+		if (ht->entries[i].key == NULL)
+			continue;
+		entries[n] = ht->entries[i];
+		for (j = entries[n].hash & (size - 1); index[j] != OHASH_EMPTY; )
+			j = (j + 1) & (size - 1);
+		index[j] = (int)n++;
+	}
+
+	free(ht->index);
+	free(ht->entries);
+	ht->index = index;
+	ht->entries = entries;
+	ht->size = size;
+	ht->capacity = capacity;
+	ht->used = n;
+	return (1);
+}
+
+/**
+ * ohash_table_create - creates an insertion-ordered hash table
+ * @size: number of keys the table should hold before growing
+ *
+ * Return: pointer to newly created table, or NULL on failure
+ */
+ohash_table_t *ohash_table_create(unsigned long int size)
+{
+	ohash_table_t *ht;
+	unsigned long int slots = 8;
+
+	if (size == 0)
+		return (NULL);
+
+	while (slots * 2 / 3 < size)
+		slots <<= 1;
+
+	ht = malloc(sizeof(ohash_table_t));
+	if (ht == NULL)
+		return (NULL);
+
+	ht->count = 0;
+	ht->used = 0;
+	ht->index = NULL;
+	ht->entries = NULL;
+	if (ohash_rebuild(ht, slots) == 0)
+	{
+		free(ht);
+		return (NULL);
+	}
+
+	return (ht);
+}
+
+/**
+ * ohash_append - appends a new entry, growing the table when full
+ * @ht: insertion-ordered hash table
+ * @hash: djb2 hash of @key
+ * @key: duplicated key, owned by the table on success
+ * @value: duplicated value, owned by the table on success
+ * @slot: free index slot found by ohash_lookup before any rebuild
+ *
+ * Return: 1 on success, 0 on failure
+ */
+static int ohash_append(ohash_table_t *ht, unsigned long int hash,
+			char *key, char *value, unsigned long int slot)
+{
+	unsigned long int size;
+
+	if (ht->used == ht->capacity)
+	{
+		size = (ht->count * 2 >= ht->capacity) ? ht->size * 2 : ht->size;
+		if (ohash_rebuild(ht, size) == 0)
+			return (0);
+		ohash_lookup(ht, key, hash, &slot);
+	}
+
+	ht->entries[ht->used].hash = hash;
+	ht->entries[ht->used].key = key;
+	ht->entries[ht->used].value = value;
+	ht->index[slot] = (int)ht->used++;
+	ht->count++;
+	return (1);
+}
+
+/**
+ * ohash_table_set - adds or updates an element in the ordered hash table
+ * @ht: insertion-ordered hash table
+ * @key: key (cannot be empty)
+ * @value: value (must be duplicated)
+ *
+ * Description: Updating a key keeps its original position.
+ * Return: 1 on success, 0 on failure
+ */
+int ohash_table_set(ohash_table_t *ht, const char *key, const char *value)
+{
+	unsigned long int hash, slot;
+	long int pos;
+	char *key_dup, *value_dup;
+
+	if (ht == NULL || ht->index == NULL || ht->size == 0)
+		return (0);
+	if (key == NULL || *key == '\0' || value == NULL)
+		return (0);
+
+	hash = hash_djb2((const unsigned char *)key);
+	pos = ohash_lookup(ht, key, hash, &slot);
+	value_dup = strdup(value);
+	if (value_dup == NULL)
+		return (0);
+	if (pos != -1)
+	{
+		free(ht->entries[pos].value);
+		ht->entries[pos].value = value_dup;
+		return (1);
+	}
+
+	key_dup = strdup(key);
+	if (key_dup == NULL || ohash_append(ht, hash, key_dup, value_dup,
+					    slot) == 0)
+	{
+		free(key_dup);
+		free(value_dup);
+		return (0);
+	}
+	return (1);
+}
+
+/**
+ * ohash_table_get - retrieves a value associated with a key
+ * @ht: insertion-ordered hash table
+ * @key: key to search for
+ *
+ * Return: value associated with key, or NULL if not found
+ */
+char *ohash_table_get(const ohash_table_t *ht, const char *key)
+{
+	unsigned long int slot;
+	long int pos;
+
+	if (ht == NULL || ht->index == NULL || ht->size == 0)
+		return (NULL);
+	if (key == NULL || *key == '\0')
+		return (NULL);
+
+	pos = ohash_lookup(ht, key, hash_djb2((const unsigned char *)key),
+			   &slot);
+	if (pos == -1)
+		return (NULL);
+
+	return (ht->entries[pos].value);
+}
@@ -0,0 +1,92 @@
+#include "hash_tables.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * ohash_table_remove - removes a key from the ordered hash table
+ * @ht: insertion-ordered hash table
+ * @key: key to remove
+ *
+ * Description: The entry is left as a hole in the dense array and its
+ * index slot as a dummy; both are reclaimed by the next rebuild.
+ * Return: 1 if the key was removed, 0 if it was not present
+ */
+int ohash_table_remove(ohash_table_t *ht, const char *key)
+{
+	unsigned long int hash, i, mask;
+	int pos;
+
+	if (ht == NULL || ht->index == NULL || ht->size == 0)
+		return (0);
+	if (key == NULL || *key == '\0')
+		return (0);
+
+	hash = hash_djb2((const unsigned char *)key);
+	mask = ht->size - 1;
+	for (i = hash & mask; ht->index[i] != OHASH_EMPTY; i = (i + 1) & mask)
+	{
+		pos = ht->index[i];
+		if (pos < 0 || ht->entries[pos].hash != hash ||
+		    strcmp(ht->entries[pos].key, key) != 0)
+			continue;
+		free(ht->entries[pos].key);
+		free(ht->entries[pos].value);
+		ht->entries[pos].key = NULL;
+		ht->entries[pos].value = NULL;
+		ht->index[i] = OHASH_DUMMY;
+		ht->count--;
+		return (1);
+	}
+
+	return (0);
+}
+
+/**
+ * ohash_table_print - prints an ordered hash table in insertion order
+ * @ht: insertion-ordered hash table
+ */
+void ohash_table_print(const ohash_table_t *ht)
+{
+	unsigned long int i;
+	int first = 1;
+
+	if (ht == NULL)
+		return;
+
+	printf("{");
+
+	for (i = 0; i < ht->used; i++)
+	{
+		if (ht->entries[i].key == NULL)
+			continue;
+		if (first == 0)
+			printf(", ");
+		printf("'%s': '%s'", ht->entries[i].key, ht->entries[i].value);
+		first = 0;
+	}
+
+	printf("}\n");
+}
+
+/**
+ * ohash_table_delete - deletes an ordered hash table
+ * @ht: insertion-ordered hash table
+ */
+void ohash_table_delete(ohash_table_t *ht)
+{
+	unsigned long int i;
+
+	if (ht == NULL)
+		return;
+
+	for (i = 0; i < ht->used; i++)
+	{
+		free(ht->entries[i].key);
+		free(ht->entries[i].value);
+	}
+
+	free(ht->index);
+	free(ht->entries);
+	free(ht);
+}
@@ -0,0 +1,118 @@
+#include "hash_tables.h"
+#include <string.h>
+
+/**
+ * shash_diff_init - starts a merge-join over two sorted hash tables
+ * @diff: cursor to initialize
+ * @old: old snapshot (may be NULL, treated as empty)
+ * @new: new snapshot (may be NULL, treated as empty)
+ *
+ * Description: Both tables must share the same key ops.
+ */
+void shash_diff_init(shash_diff_t *diff, const shash_table_t *old,
+		     const shash_table_t *new)
+{
+	if (diff == NULL)
+		return;
+
+	diff->ht = (old != NULL) ? old : new;
+	diff->old = (old != NULL) ? old->shead : NULL;
+	diff->new = (new != NULL) ? new->shead : NULL;
+}
+
+/**
+ * shash_diff_next - yields the next difference between two sorted tables
+ * @diff: cursor set up by shash_diff_init
+ * @old: set to the node of the old table (NULL for an added key)
+ * @new: set to the node of the new table (NULL for a removed key)
+ *
+ * Description: Both tables are walked once through snext, in key order,
+ * so a full diff is linear in the size of the two tables.
+ * Return: kind of difference found, SHASH_DIFF_END when done
+ */
+shash_diff_kind_t shash_diff_next(shash_diff_t *diff,
+				  const shash_node_t **old,
+				  const shash_node_t **new)
+{
+	int cmp;
+
+	if (diff == NULL || old == NULL || new == NULL)
+		return (SHASH_DIFF_END);
+
+	while (diff->old != NULL || diff->new != NULL)
+	{
+		if (diff->old == NULL)
+			cmp = 1;
+		else if (diff->new == NULL)
+			cmp = -1;
+		else
+			cmp = SHASH_CMP(diff->ht, diff->old->key, diff->new->key);
+
+		*old = (cmp <= 0) ? diff->old : NULL;
+		*new = (cmp >= 0) ? diff->new : NULL;
+		if (cmp <= 0)
+			diff->old = diff->old->snext;
+		if (cmp >= 0)
+			diff->new = diff->new->snext;
+
+		if (cmp < 0)
+			return (SHASH_DIFF_REMOVED);
+		if (cmp > 0)
+			return (SHASH_DIFF_ADDED);
+		if (strcmp((*old)->value, (*new)->value) != 0)
+			return (SHASH_DIFF_CHANGED);
+	}
+
+	*old = NULL;
+	*new = NULL;
+	return (SHASH_DIFF_END);
+}
+
+/**
+ * shash_table_merge - builds a sorted hash table holding two tables' keys
+ * @a: first sorted hash table
+ * @b: second sorted hash table, whose values win on common keys
+ *
+ * Description: Both tables must share the same key ops, which the merged
+ * table inherits. Keys are inserted in ascending order, so every insertion
+ * appends to the tail of the sorted list.
+ * Return: pointer to the new table, or NULL on failure
+ */
+shash_table_t *shash_table_merge(const shash_table_t *a,
+				 const shash_table_t *b)
+{
+	shash_table_t *ht;
+	const shash_node_t *na, *nb;
+	int cmp;
+
+	if (a == NULL || b == NULL)
+		return (NULL);
+
+	ht = shash_table_create_ops(a->size > b->size ? a->size : b->size,
+				    a->ops);
+	if (ht == NULL)
+		return (NULL);
+
+	for (na = a->shead, nb = b->shead; na != NULL || nb != NULL; )
+	{
+		if (na == NULL)
+			cmp = 1;
+		else if (nb == NULL)
+			cmp = -1;
+		else
+			cmp = SHASH_CMP(a, na->key, nb->key);
+
+		if (shash_table_set(ht, cmp < 0 ? na->key : nb->key,
+				    cmp < 0 ? na->value : nb->value) == 0)
+		{
+			shash_table_delete(ht);
+			return (NULL);
+		}
+		if (cmp <= 0)
+			na = na->snext;
+		if (cmp >= 0)
+			nb = nb->snext;
+	}
+
+	return (ht);
+}
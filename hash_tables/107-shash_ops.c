@@ -0,0 +1,111 @@
+#include "hash_tables.h"
+#include <ctype.h>
+#include <string.h>
+
+/**
+ * shash_cmp_casefold - orders two keys ignoring ASCII case
+ * @a: first key
+ * @b: second key
+ *
+ * Return: negative, 0 or positive like strcmp
+ */
+int shash_cmp_casefold(const char *a, const char *b)
+{
+	int ca, cb;
+
+	do {
+		ca = tolower((unsigned char)*a++);
+		cb = tolower((unsigned char)*b++);
+	} while (ca == cb && ca != '\0');
+
+	return (ca - cb);
+}
+
+/**
+ * shash_hash_casefold - djb2 over the lowercased key
+ * @key: key to hash
+ *
+ * Return: hash value, equal for keys equal under shash_cmp_casefold
+ */
+unsigned long int shash_hash_casefold(const unsigned char *key)
+{
+	unsigned long int hash;
+	int c;
+
+	hash = 5381;
+	while ((c = *key++))
+		hash = ((hash << 5) + hash) + tolower(c); /* hash * 33 + c */
+
+	return (hash);
+}
+
+/**
+ * shash_cmp_natural - orders two keys with embedded numbers by value
+ * @a: first key
+ * @b: second key
+ *
+ * Description: "file9" sorts before "file10". Runs of digits compare by
+ * numeric value (leading zeros ignored), everything else byte by byte.
+ * Keys that tie ("a01", "a1") fall back to strcmp, so only identical
+ * keys compare equal and djb2 stays a valid hash.
+ * Return: negative, 0 or positive like strcmp
+ */
+int shash_cmp_natural(const char *a, const char *b)
+{
+	const char *pa = a, *pb = b;
+	size_t la, lb;
+	int diff;
+
+	while (*pa != '\0' && *pb != '\0')
+	{
+		if (!isdigit((unsigned char)*pa) || !isdigit((unsigned char)*pb))
+		{
+			if (*pa != *pb)
+				return ((unsigned char)*pa - (unsigned char)*pb);
+			pa++, pb++;
+			continue;
+		}
+		while (*pa == '0')
+			pa++;
+		while (*pb == '0')
+			pb++;
+		for (la = 0; isdigit((unsigned char)pa[la]); la++)
+			;
+		for (lb = 0; isdigit((unsigned char)pb[lb]); lb++)
+			;
+		if (la != lb)
+			return (la < lb ? -1 : 1);
+		diff = strncmp(pa, pb, la);
+		if (diff != 0)
+			return (diff);
+		pa += la, pb += lb;
+	}
+
+	if (*pa != *pb)
+		return ((unsigned char)*pa - (unsigned char)*pb);
+	return (strcmp(a, b));
+}
+
+/**
+ * shash_cmp_shortlex - orders keys by length, then byte by byte
+ * @a: first key
+ * @b: second key
+ *
+ * Description: The order of length-prefixed binary keys; the length check
+ * settles most comparisons without touching the key bytes.
+ * Return: negative, 0 or positive like strcmp
+ */
+int shash_cmp_shortlex(const char *a, const char *b)
+{
+	size_t la = strlen(a), lb = strlen(b);
+
+	if (la != lb)
+		return (la < lb ? -1 : 1);
+
+	return (memcmp(a, b, la));
+}
+
+const shash_ops_t shash_ops_casefold = {shash_cmp_casefold,
+					shash_hash_casefold};
+const shash_ops_t shash_ops_natural = {shash_cmp_natural, hash_djb2};
+const shash_ops_t shash_ops_shortlex = {shash_cmp_shortlex, hash_djb2};
@@ -3,6 +3,7 @@
 
 #include <stddef.h> /* NULL */
 #include <stdlib.h> /* malloc, free */
+#include <string.h> /* strcmp */
 
 /**
  * struct hash_node_s - Node of a hash table
@@ -48,12 +49,24 @@ typedef struct shash_node_s
 	struct shash_node_s *snext;
 } shash_node_t;
 
+/**
+ * struct shash_ops_s - Key behaviour of a sorted hash table
+ * @cmp: Orders two keys like strcmp; keys comparing equal are the same key
+ * @hash: Hash function consistent with @cmp (equal keys, equal hashes)
+ */
+typedef struct shash_ops_s
+{
+	int (*cmp)(const char *a, const char *b);
+	unsigned long int (*hash)(const unsigned char *key);
+} shash_ops_t;
+
 /**
  * struct shash_table_s - Sorted hash table data structure
  * @size: The size of the array
  * @array: Array of pointers to buckets (chains)
  * @shead: Head of the sorted linked list
  * @stail: Tail of the sorted linked list
+ * @ops: Key ordering and hash, NULL for strcmp order and djb2
  */
 typedef struct shash_table_s
 {
@@ -61,8 +74,123 @@ typedef struct shash_table_s
 	shash_node_t **array;
 	shash_node_t *shead;
 	shash_node_t *stail;
+	const shash_ops_t *ops;
 } shash_table_t;
 
+/**
+ * SHASH_CMP - compares two keys the way a sorted hash table orders them
+ * @ht: sorted hash table
+ * @a: first key
+ * @b: second key
+ */
+#define SHASH_CMP(ht, a, b) \
+	((ht)->ops == NULL ? strcmp((a), (b)) : (ht)->ops->cmp((a), (b)))
+
+extern const shash_ops_t shash_ops_casefold;
+extern const shash_ops_t shash_ops_natural;
+extern const shash_ops_t shash_ops_shortlex;
+
+/**
+ * enum shash_diff_kind_e - Kind of difference between two sorted tables
+ * @SHASH_DIFF_END: Both tables have been fully walked
+ * @SHASH_DIFF_ADDED: The key is only in the new table
+ * @SHASH_DIFF_REMOVED: The key is only in the old table
+ * @SHASH_DIFF_CHANGED: The key is in both tables with different values
+ */
+typedef enum shash_diff_kind_e
+{
+	SHASH_DIFF_END,
+	SHASH_DIFF_ADDED,
+	SHASH_DIFF_REMOVED,
+	SHASH_DIFF_CHANGED
+} shash_diff_kind_t;
+
+/**
+ * struct shash_diff_s - Cursor of a merge-join over two sorted tables
+ * @ht: Table whose key ordering drives the walk
+ * @old: Next node of the old table still to be compared
+ * @new: Next node of the new table still to be compared
+ *
+ * Description: Lives on the caller's stack; walking a diff never allocates.
+ */
+typedef struct shash_diff_s
+{
+	const shash_table_t *ht;
+	const shash_node_t *old;
+	const shash_node_t *new;
+} shash_diff_t;
+
+/**
+ * struct hash_set_node_s - Node of a hash set
+ * @next: A pointer to the next node of the List
+ * @hash: The full djb2 hash of @key, compared before the key itself
+ * @key: The key, stored inline right after the node header
+ *
+ * Description: Node and key live in a single allocation, so a set member
+ * costs one malloc instead of a node, a key and an empty value.
+ */
+typedef struct hash_set_node_s
+{
+	struct hash_set_node_s *next;
+	unsigned long int hash;
+	char key[1];
+} hash_set_node_t;
+
+/**
+ * struct hash_set_s - Hash set data structure
+ * @size: The size of the array
+ * @count: The number of keys stored in the set
+ * @array: An array of size @size
+ *
+ * Description: Same chaining layout as hash_table_t, keys only.
+ */
+typedef struct hash_set_s
+{
+	unsigned long int size;
+	unsigned long int count;
+	hash_set_node_t **array;
+} hash_set_t;
+
+/**
+ * struct ohash_entry_s - Entry of an insertion-ordered hash table
+ * @hash: The full djb2 hash of @key
+ * @key: The key, string; NULL once the entry has been removed
+ * @value: The value corresponding to a key
+ */
+typedef struct ohash_entry_s
+{
+	unsigned long int hash;
+	char *key;
+	char *value;
+} ohash_entry_t;
+
+/* Markers stored in ohash_table_t.index besides entry positions */
+#define OHASH_EMPTY (-1)
+#define OHASH_DUMMY (-2)
+
+/**
+ * struct ohash_table_s - Insertion-ordered hash table data structure
+ * @size: The number of slots of @index (a power of two)
+ * @count: The number of live entries
+ * @used: The number of entries appended to @entries, removed ones included
+ * @capacity: The number of entries @entries can hold
+ * @index: Open-addressed slots holding positions into @entries
+ * @entries: Dense array of entries, in insertion order
+ *
+ * Description: Same layout as a modern Python dict. The sparse @index only
+ * stores small integers, and the entries themselves are packed, so walking
+ * the table is a linear scan of @entries in the order keys were added.
+ */
+typedef struct ohash_table_s
+{
+	unsigned long int size;
+	unsigned long int count;
+	unsigned long int used;
+	unsigned long int capacity;
+	int *index;
+	ohash_entry_t *entries;
+} ohash_table_t;
+
 /* Basic hash table (tasks 0-6) */
 hash_table_t *hash_table_create(unsigned long int size);
 unsigned long int hash_djb2(const unsigned char *str);
@@ -74,11 +202,46 @@ void hash_table_delete(hash_table_t *ht);
 
 /* Sorted hash table (task 100) */
 shash_table_t *shash_table_create(unsigned long int size);
+shash_table_t *shash_table_create_ops(unsigned long int size,
+				      const shash_ops_t *ops);
 int shash_table_set(shash_table_t *ht, const char *key, const char *value);
 char *shash_table_get(const shash_table_t *ht, const char *key);
 void shash_table_print(const shash_table_t *ht);
 void shash_table_print_rev(const shash_table_t *ht);
 void shash_table_delete(shash_table_t *ht);
+void shash_diff_init(shash_diff_t *diff, const shash_table_t *old,
+		     const shash_table_t *new);
+shash_diff_kind_t shash_diff_next(shash_diff_t *diff,
+				  const shash_node_t **old,
+				  const shash_node_t **new);
+shash_table_t *shash_table_merge(const shash_table_t *a,
+				 const shash_table_t *b);
+
+/* Hash set (tasks 101-102) */
+hash_set_t *hash_set_create(unsigned long int size);
+int hash_set_add(hash_set_t *set, const char *key);
+int hash_set_contains(const hash_set_t *set, const char *key);
+int hash_set_remove(hash_set_t *set, const char *key);
+void hash_set_delete(hash_set_t *set);
+void hash_set_foreach(const hash_set_t *set,
+		      void (*action)(const char *key, void *data), void *data);
+void hash_set_print(const hash_set_t *set);
+hash_set_t *hash_set_union(const hash_set_t *a, const hash_set_t *b);
+hash_set_t *hash_set_intersection(const hash_set_t *a, const hash_set_t *b);
+
+/* Sorted hash table key modes (task 107) */
+int shash_cmp_casefold(const char *a, const char *b);
+unsigned long int shash_hash_casefold(const unsigned char *key);
+int shash_cmp_natural(const char *a, const char *b);
+int shash_cmp_shortlex(const char *a, const char *b);
+
+/* Insertion-ordered hash table (tasks 104-105) */
+ohash_table_t *ohash_table_create(unsigned long int size);
+int ohash_table_set(ohash_table_t *ht, const char *key, const char *value);
+char *ohash_table_get(const ohash_table_t *ht, const char *key);
+int ohash_table_remove(ohash_table_t *ht, const char *key);
+void ohash_table_print(const ohash_table_t *ht);
+void ohash_table_delete(ohash_table_t *ht);
 
 #endif /* HASH_TABLES_H */
 
@@ -0,0 +1,199 @@
+#ifndef INT_MAP_H
+#define INT_MAP_H
+
+#include <stddef.h> /* NULL */
+#include <stdlib.h> /* malloc, calloc, free */
+#include <stdint.h> /* uint32_t, uint64_t */
+
+/*
+ * Integer-keyed hash maps, generated from one template.
+ *
+ * INT_MAP_DECLARE(name, key_type, value_type) declares:
+ *   name_t - the map: a flat, open-addressed array of {key, value} slots
+ *            whose capacity is a power of two, probed linearly.
+ *   name_create(size)              - map able to hold @size keys unresized
+ *   name_set(map, key, value)      - 1 on success, 0 on failure
+ *   name_get(map, key, &value)     - 1 and *value set if found, 0 otherwise
+ *   name_remove(map, key)          - 1 if removed, 0 if not present
+ *   name_delete(map)
+ *
+ * INT_MAP_DEFINE(name, key_type, value_type, mix) emits the functions;
+ * @mix scrambles a key into an unsigned long so that sequential IDs spread
+ * over the whole table. Key 0 marks an empty slot, so it is kept on the
+ * side in has_zero/zero_value. Removal shifts the following run back
+ * instead of leaving tombstones, so lookups never slow down with churn.
+ */
+
+#define INT_MAP_DECLARE(name, key_type, value_type) \
+typedef struct name##_slot_s \
+{ \
+	key_type key; \
+	value_type value; \
+} name##_slot_t; \
+typedef struct name##_s \
+{ \
+	unsigned long int mask; \
+	unsigned long int count; \
+	int has_zero; \
+	value_type zero_value; \
+	name##_slot_t *slots; \
+} name##_t; \
+name##_t *name##_create(unsigned long int size); \
+int name##_set(name##_t *map, key_type key, value_type value); \
+int name##_get(const name##_t *map, key_type key, value_type *value); \
+int name##_remove(name##_t *map, key_type key); \
+void name##_delete(name##_t *map)
+
+#define INT_MAP_DEFINE_CORE(name, key_type, value_type, mix) \
+static unsigned long int name##_find(const name##_t *map, key_type key) \
+{ \
+	unsigned long int i = (mix(key)) & map->mask; \
+\
+	while (map->slots[i].key != 0 && map->slots[i].key != key) \
+		i = (i + 1) & map->mask; \
+	return (i); \
+} \
+static int name##_grow(name##_t *map) \
+{ \
+	name##_slot_t *old = map->slots; \
+	unsigned long int i, j, old_cap = map->mask + 1; \
+\
+	map->slots = calloc(old_cap * 2, sizeof(name##_slot_t)); \
+	if (map->slots == NULL) \
+	{ \
+		map->slots = old; \
+		return (0); \
+	} \
+	map->mask = old_cap * 2 - 1; \
+	for (i = 0; i < old_cap; i++) \
+	{ \
+		if (old[i].key == 0) \
+			continue; \
+		j = name##_find(map, old[i].key); \
+		map->slots[j] = old[i]; \
+	} \
+	free(old); \
+	return (1); \
+} \
+name##_t *name##_create(unsigned long int size) \
+{ \
+	name##_t *map; \
+	unsigned long int cap = 8; \
+\
+	while (cap - cap / 4 < size) \
+		cap <<= 1; \
+	map = malloc(sizeof(name##_t)); \
+	if (map == NULL) \
+		return (NULL); \
+	map->slots = calloc(cap, sizeof(name##_slot_t)); \
+	if (map->slots == NULL) \
+	{ \
+		free(map); \
+		return (NULL); \
+	} \
+	map->mask = cap - 1; \
+	map->count = 0; \
+	map->has_zero = 0; \
+	return (map); \
+}
+
+#define INT_MAP_DEFINE_ACCESS(name, key_type, value_type, mix) \
+int name##_set(name##_t *map, key_type key, value_type value) \
+{ \
+	unsigned long int i; \
+\
+	if (map == NULL) \
+		return (0); \
+	if (key == 0) \
+	{ \
+		map->count += (map->has_zero == 0); \
+		map->has_zero = 1; \
+		map->zero_value = value; \
+		return (1); \
+	} \
+	i = name##_find(map, key); \
+	if (map->slots[i].key == 0) \
+	{ \
+		if (map->count + 1 > map->mask - map->mask / 4) \
+		{ \
+			if (name##_grow(map) == 0) \
+				return (0); \
+			i = name##_find(map, key); \
+		} \
+		map->slots[i].key = key; \
+		map->count++; \
+	} \
+	map->slots[i].value = value; \
+	return (1); \
+} \
+int name##_get(const name##_t *map, key_type key, value_type *value) \
+{ \
+	unsigned long int i; \
+\
+	if (map == NULL) \
+		return (0); \
+	if (key == 0) \
+	{ \
+		if (map->has_zero && value != NULL) \
+			*value = map->zero_value; \
+		return (map->has_zero); \
+	} \
+	i = name##_find(map, key); \
+	if (map->slots[i].key == 0) \
+		return (0); \
+	if (value != NULL) \
+		*value = map->slots[i].value; \
+	return (1); \
+}
+
+#define INT_MAP_DEFINE_REMOVE(name, key_type, value_type, mix) \
+int name##_remove(name##_t *map, key_type key) \
+{ \
+	unsigned long int i, j, k; \
+\
+	if (map == NULL || (key == 0 && map->has_zero == 0)) \
+		return (0); \
+	if (key == 0) \
+	{ \
+		map->has_zero = 0; \
+		map->count--; \
+		return (1); \
+	} \
+	i = name##_find(map, key); \
+	if (map->slots[i].key == 0) \
+		return (0); \
+	for (j = (i + 1) & map->mask; map->slots[j].key != 0; \
+	     j = (j + 1) & map->mask) \
+	{ \
+		k = (mix(map->slots[j].key)) & map->mask; \
+		if (((j - k) & map->mask) >= ((j - i) & map->mask)) \
+		{ \
+			map->slots[i] = map->slots[j]; \
+			i = j; \
+		} \
+	} \
+	map->slots[i].key = 0; \
+	map->count--; \
+	return (1); \
+} \
+void name##_delete(name##_t *map) \
+{ \
+	if (map == NULL) \
+		return; \
+	free(map->slots); \
+	free(map); \
+}
+
+#define INT_MAP_DEFINE(name, key_type, value_type, mix) \
+INT_MAP_DEFINE_CORE(name, key_type, value_type, mix) \
+INT_MAP_DEFINE_ACCESS(name, key_type, value_type, mix) \
+INT_MAP_DEFINE_REMOVE(name, key_type, value_type, mix)
+
+unsigned long int int_map_mix32(uint32_t key);
+unsigned long int int_map_mix64(uint64_t key);
+
+INT_MAP_DECLARE(u32_map, uint32_t, void *);
+INT_MAP_DECLARE(u64_map, uint64_t, void *);
+INT_MAP_DECLARE(u64_u64_map, uint64_t, uint64_t);
+
+#endif /* INT_MAP_H */
@@ -2,6 +2,10 @@
 #define MAIN_H
 
 int _putchar(char c);
+int _putchar_flush(void);
+int _putbuf(const char *buf, unsigned int len);
+int _putstr(const char *s);
+int _putnum(long n);
 char *create_array(unsigned int size, char c);
 char *_strdup(char *str);
 char *str_concat(char *s1, char *s2);
@@ -2,6 +2,10 @@
 #define MAIN_H
 
 int _putchar(char c);
+int _putchar_flush(void);
+int _putbuf(const char *buf, unsigned int len);
+int _putstr(const char *s);
+int _putnum(long n);
 int _isupper(int c);
 int _isdigit(int c);
 int mul(int a, int b);
@@ -8,10 +8,6 @@
 
 void _puts(char *str)
 {
-	while (*str != '\0')
-	{
-		_putchar(*str);
-		str++;
-	}
+	_putstr(str);
 	_putchar('\n');
 }
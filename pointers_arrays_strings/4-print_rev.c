@@ -5,19 +5,27 @@
  * @s: I do not fear computers.
  * I fear the lack of them - Isaac Asimov
  *
+ * Description: The string is reversed into a small buffer which is
+ * handed to _putbuf each time it fills.
  * Return: void
  */
 void print_rev(char *s)
 {
-	int len = 0;
-
+	char buf[256];
+	int len = 0, n = 0;
 
 	while (s[len] != '\0')
 		len++;
 
 	for (len = len - 1; len >= 0; len--)
-		_putchar(s[len]);
-
-	_putchar('\n');
+	{
+		buf[n++] = s[len];
+		if (n == (int)sizeof(buf))
+		{
+			_putbuf(buf, n);
+			n = 0;
+		}
+	}
+	buf[n] = '\n';
+	_putbuf(buf, n + 1);
 }
-
@@ -4,18 +4,26 @@
  * puts2 - prints every other character of a string
  * @str: the string to process
  *
+ * Description: The characters kept are gathered into a small buffer
+ * which is handed to _putbuf each time it fills.
  * Return: void
  */
 void puts2(char *str)
 {
-	int i;
+	char buf[256];
+	int i, n = 0;
 
 	for (i = 0; str[i] != '\0'; i++)
 	{
 		if (i % 2 == 0)
-			_putchar(str[i]);
+			buf[n++] = str[i];
+		if (n == (int)sizeof(buf))
+		{
+			_putbuf(buf, n);
+			n = 0;
+		}
 	}
 
-	_putchar('\n');
+	buf[n] = '\n';
+	_putbuf(buf, n + 1);
 }
-
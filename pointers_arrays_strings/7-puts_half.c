@@ -19,12 +19,7 @@ void puts_half(char *str)
 	else
 		start = (len + 1) / 2;
 
-	while (start < len)
-	{
-		_putchar(str[start]);
-		start++;
-	}
-
+	_putbuf(str + start, len - start);
 	_putchar('\n');
 }
 
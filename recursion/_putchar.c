@@ -1,13 +1,138 @@
+/*
+ * Build with -DPUTCHAR_BUFFERED to buffer the output through stdio. The
+ * buffer is the one of stdout, shared by all threads under the stdio
+ * lock, rather than one per thread: a per-thread buffer would print
+ * each thread's output, and printf's, out of order.
+ */
 #include <unistd.h>
+#include <errno.h>
+#ifdef PUTCHAR_BUFFERED
+#include <stdio.h>
+#endif
+
+/**
+ * _putchar_flush - writes out the buffered output
+ *
+ * Description: Only does something with PUTCHAR_BUFFERED, where it
+ * flushes stdout. Call it before writing to fd 1 with write(2), or
+ * before _exit, so the buffered output is not reordered or lost.
+ * Return: 0 on success, -1 on error with errno set.
+ */
+int _putchar_flush(void)
+{
+#ifdef PUTCHAR_BUFFERED
+	return (fflush(stdout) == 0 ? 0 : -1);
+#else
+	return (0);
+#endif
+}
+
+/**
+ * _putbuf - writes a span of bytes to stdout
+ * @buf: the bytes
+ * @len: the number of bytes
+ *
+ * Description: By default the span goes out with write(2) right away,
+ * short writes and EINTR retried. With PUTCHAR_BUFFERED it is added to
+ * the stdio buffer of stdout, so it keeps its place among printf output
+ * and is flushed by exit like it.
+ * Return: @len on success, -1 on error with errno set.
+ */
+int _putbuf(const char *buf, unsigned int len)
+{
+#ifdef PUTCHAR_BUFFERED
+	return (fwrite(buf, 1, len, stdout) == len ? (int)len : -1);
+#else
+	unsigned int done = 0;
+	ssize_t w;
+
+	while (done < len)
+	{
+		w = write(1, buf + done, len - done);
+		if (w == -1 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			return (-1);
+		done += w;
+	}
+
+	return (len);
+#endif
+}
 
 /**
  * _putchar - writes the character c to stdout
  * @c: The character to print
  *
+ * Description: Unbuffered by default, one write(2) per character. Built
+ * with PUTCHAR_BUFFERED it goes through the stdio buffer of stdout
+ * instead, in order with printf; the output is then only written when
+ * stdio flushes stdout, and is lost if the program ends with _exit,
+ * abort or a signal.
  * Return: On success 1.
  * On error, -1 is returned, and errno is set appropriately.
  */
 int _putchar(char c)
 {
+#ifdef PUTCHAR_BUFFERED
+	return (putchar((unsigned char)c) == EOF ? -1 : 1);
+#else
 	return (write(1, &c, 1));
+#endif
+}
+
+/**
+ * _putstr - writes a string to stdout with a single _putbuf
+ * @s: the string
+ *
+ * Return: the number of bytes written, -1 on error
+ */
+int _putstr(const char *s)
+{
+	const char *end = s;
+
+	while (*end != '\0')
+		end++;
+
+	return (_putbuf(s, end - s));
+}
+
+/**
+ * _putnum - writes an integer in decimal to stdout
+ * @n: the integer, LONG_MIN included
+ *
+ * Description: Digits are produced two at a time from a table of the
+ * pairs 00 to 99, halving the divisions of the usual digit loop, and
+ * the whole number goes out in one _putbuf.
+ * Return: the number of bytes written, -1 on error
+ */
+int _putnum(long n)
+{
+	static const char pairs[] =
+		"00010203040506070809101112131415161718192021222324"
+		"25262728293031323334353637383940414243444546474849"
+		"50515253545556575859606162636465666768697071727374"
+		"75767778798081828384858687888990919293949596979899";
+	char buf[24], *p = buf + sizeof(buf);
+	unsigned long u = n < 0 ? 0UL - (unsigned long)n : (unsigned long)n;
+
+	while (u >= 100)
+	{
+		p -= 2;
+		p[0] = pairs[(u % 100) * 2];
+		p[1] = pairs[(u % 100) * 2 + 1];
+		u /= 100;
+	}
+	if (u >= 10)
+	{
+		p -= 2;
+		p[0] = pairs[u * 2];
+		p[1] = pairs[u * 2 + 1];
+	}
+	else
+		*--p = '0' + u;
+	if (n < 0)
+		*--p = '-';
+
+	return (_putbuf(p, buf + sizeof(buf) - p));
 }